@@ -0,0 +1,176 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/*!
+ * \file ErriezBMX280ArchiveBenchmark.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Size and range query speed of a columnar archive of synthetic samples, one
+ *      per minute, in RAM storage: full scan, time range and value filter skipped by
+ *      zone maps. No sensor required.
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <ErriezBMX280Archive.h>
+
+// Archive size in RAM
+#if defined(ARDUINO_ARCH_AVR)
+#define ARCHIVE_SIZE        1024
+#else
+#define ARCHIVE_SIZE        16384
+#endif
+
+// Chunk size and samples per chunk
+#define CHUNK_SIZE          256
+#define CHUNK_SAMPLES       64
+
+/*!
+ * \brief RAM storage
+ */
+class RamStorage : public ErriezBMX280Storage
+{
+public:
+    bool read(uint32_t addr, uint8_t *buffer, uint16_t len)
+    {
+        memcpy(buffer, &_mem[addr], len);
+        return true;
+    }
+
+    bool write(uint32_t addr, const uint8_t *buffer, uint16_t len)
+    {
+        memcpy(&_mem[addr], buffer, len);
+        return true;
+    }
+
+    uint32_t size()
+    {
+        return sizeof(_mem);
+    }
+
+private:
+    uint8_t _mem[ARCHIVE_SIZE];
+};
+
+RamStorage storage;
+BMX280_ArchiveSample_t samples[CHUNK_SAMPLES];
+ErriezBMX280Archive archive = ErriezBMX280Archive(&storage, samples, CHUNK_SAMPLES, CHUNK_SIZE);
+
+
+void fill()
+{
+    BMX280_ArchiveSample_t sample;
+    uint32_t seed = 1;
+
+    sample.timestamp = 0;
+    sample.temperature = 2000;
+    sample.pressure = 101325UL * 256;
+    sample.humidity = 50UL * 1024;
+
+    // Random walk with a daily temperature swing, until the last chunk is reached
+    while (archive.getChunks() < (archive.getCapacity() - 1)) {
+        seed = seed * 1103515245UL + 12345;
+        sample.timestamp += 60;
+        sample.temperature += ((sample.timestamp % 86400UL) < 43200UL) ? 1 : -1;
+        sample.temperature += (int8_t)((seed >> 16) % 7) - 3;
+        sample.pressure += (int16_t)((seed >> 8) & 0x3F) - 32;
+        sample.humidity += (int16_t)((seed >> 20) & 0x1F) - 16;
+        if (!archive.append(sample)) {
+            break;
+        }
+    }
+    archive.flush();
+}
+
+void benchmarkQuery(const __FlashStringHelper *name, const BMX280_ArchiveRange_t &range)
+{
+    uint32_t start = micros();
+    uint32_t matches = archive.query(range, NULL);
+    uint32_t us = micros() - start;
+
+    Serial.print(F("| "));
+    Serial.print(name);
+    Serial.print(F(" | "));
+    Serial.print(matches);
+    Serial.print(F(" | "));
+    Serial.print(archive.getChunksRead());
+    Serial.print(F("/"));
+    Serial.print(archive.getChunks());
+    Serial.print(F(" | "));
+    Serial.print(us);
+    Serial.print(F(" | "));
+    Serial.print(us ? (uint32_t)((uint64_t)archive.getSamplesRead() * 1000000UL / us) : 0);
+    Serial.print(F(" | "));
+    Serial.print(archive.getReadErrors());
+    Serial.println(F(" |"));
+}
+
+void setup()
+{
+    BMX280_ArchiveRange_t range;
+
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 archive benchmark"));
+
+    if (!archive.begin() || !archive.format()) {
+        Serial.println(F("Error: Archive too small"));
+        return;
+    }
+    fill();
+
+    Serial.print(F("Samples: "));
+    Serial.print(archive.count());
+    Serial.print(F(", bytes/sample: "));
+    Serial.println((float)archive.getChunks() * CHUNK_SIZE / archive.count());
+    Serial.println();
+
+    Serial.println(F("| Query | Matches | Chunks decoded | us | Decoded samples/s | Read errors |"));
+    Serial.println(F("| --- | --- | --- | --- | --- | --- |"));
+
+    bmx280ArchiveRangeAll(&range);
+    benchmarkQuery(F("All samples"), range);
+
+    range.timeFrom = (archive.count() / 2) * 60UL;
+    range.timeTo = range.timeFrom + 3600;
+    benchmarkQuery(F("One hour"), range);
+
+    bmx280ArchiveRangeAll(&range);
+    range.temperatureMin = 2100;
+    benchmarkQuery(F("Temperature >= 21.00"), range);
+
+    Serial.println();
+}
+
+void loop()
+{
+
+}
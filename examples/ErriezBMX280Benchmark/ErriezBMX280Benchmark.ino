@@ -0,0 +1,186 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Benchmark.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Cycles per call of the compensation kernels and bit-exact check of the
+ *      optimized kernels against the datasheet formulas. No sensor required.
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <ErriezBMX280.h>
+
+#ifndef F_CPU
+#define F_CPU               16000000UL
+#endif
+
+// Number of calls per measurement
+#define ITERATIONS          1000
+
+// Typical coefficients
+static const BMX280_Calib_t calib = {
+    27504, 26435, -1000,
+    36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+    75, 362, 0, 313, 50, 30
+};
+
+// Keep results to prevent the compiler from removing the calls
+volatile uint32_t sink;
+
+
+void printRow(const __FlashStringHelper *name, uint32_t us)
+{
+    Serial.print(F("| "));
+    Serial.print(name);
+    Serial.print(F(" | "));
+    Serial.print((uint32_t)(((uint64_t)us * (F_CPU / 1000000UL)) / ITERATIONS));
+    Serial.println(F(" |"));
+}
+
+void checkPressure()
+{
+    BMX280_PressureCache_t cache;
+    uint16_t mismatches = 0;
+
+    bmx280PressureCacheReset(&cache);
+
+    // t_fine -40..+85 degree Celsius, full 20-bit ADC range
+    for (int32_t t_fine = -204800; t_fine <= 435200; t_fine += 20000) {
+        for (int32_t adc_P = 0; adc_P < 1048576L; adc_P += 32768L) {
+            if (bmx280CompensateP(&calib, adc_P, t_fine) !=
+                bmx280CompensatePCached(&calib, &cache, adc_P, t_fine)) {
+                mismatches++;
+            }
+        }
+    }
+
+    Serial.print(F("Pressure cached bit-exact: "));
+    Serial.println(mismatches ? F("FAIL") : F("OK"));
+}
+
+void checkTemperatureHumidity()
+{
+    int32_t t_fine, t_fine_fast;
+    uint16_t mismatches = 0;
+
+    // Full 20-bit temperature ADC range, full 16-bit humidity ADC range
+    for (int32_t adc_T = 0; adc_T < 1048576L; adc_T += 4099) {
+        if (bmx280CompensateT(&calib, adc_T, &t_fine) !=
+            bmx280CompensateTFast(&calib, adc_T, &t_fine_fast) || (t_fine != t_fine_fast)) {
+            mismatches++;
+        }
+        for (int32_t adc_H = (adc_T & 0x1FF); adc_H < 65536L; adc_H += 4099) {
+            if (bmx280CompensateH(&calib, adc_H, t_fine) !=
+                bmx280CompensateHFast(&calib, adc_H, t_fine)) {
+                mismatches++;
+            }
+        }
+    }
+
+    Serial.print(F("Temperature/humidity fast bit-exact: "));
+    Serial.println(mismatches ? F("FAIL") : F("OK"));
+}
+
+void benchmarkCompensation()
+{
+    BMX280_PressureCache_t cache;
+    int32_t t_fine;
+    uint32_t start;
+
+    bmx280PressureCacheReset(&cache);
+    bmx280CompensateT(&calib, 519888, &t_fine);
+
+    Serial.println(F("| Kernel | Cycles/call |"));
+    Serial.println(F("| --- | --- |"));
+
+    start = micros();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280CompensateT(&calib, 519888 + i, &t_fine);
+    }
+    printRow(F("bmx280CompensateT"), micros() - start);
+
+    start = micros();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280CompensateTFast(&calib, 519888 + i, &t_fine);
+    }
+    printRow(F("bmx280CompensateTFast"), micros() - start);
+
+    start = micros();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280CompensateP(&calib, 415148 + i, t_fine);
+    }
+    printRow(F("bmx280CompensateP"), micros() - start);
+
+    start = micros();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280CompensatePCached(&calib, &cache, 415148 + i, t_fine);
+    }
+    printRow(F("bmx280CompensatePCached"), micros() - start);
+
+    start = micros();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280CompensatePCached(&calib, &cache, 415148 + i, t_fine + (i & 1));
+    }
+    printRow(F("bmx280CompensatePCached, t_fine changes"), micros() - start);
+
+    start = micros();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280CompensateH(&calib, 30000 + i, t_fine);
+    }
+    printRow(F("bmx280CompensateH"), micros() - start);
+
+    start = micros();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280CompensateHFast(&calib, 30000 + i, t_fine);
+    }
+    printRow(F("bmx280CompensateHFast"), micros() - start);
+}
+
+void setup()
+{
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 benchmark"));
+    Serial.print(F("F_CPU: "));
+    Serial.println(F_CPU);
+
+    checkPressure();
+    checkTemperatureHumidity();
+    Serial.println();
+
+    benchmarkCompensation();
+}
+
+void loop()
+{
+
+}
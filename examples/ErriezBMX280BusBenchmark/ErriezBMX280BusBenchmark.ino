@@ -0,0 +1,158 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280BusBenchmark.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Worst case bus latency and sampling jitter of a critical sensor sharing a bus
+ *      with 12 logging sensors, and the CPU load of the scheduler. The sensor set is
+ *      feasible, so misses indicate a scheduling fault. isFeasible() is printed after
+ *      the run, when the bus time of each sensor has been measured. Runs on any board
+ *      without sensors by using a mock bus.
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <ErriezBMX280.h>
+#include <ErriezBMX280Scheduler.h>
+
+// Number of sensors: 1 critical + 12 logging
+#define NUM_SENSORS         13
+
+// Benchmark duration per configuration
+#define DURATION_MS         10000
+
+/*!
+ * \brief Mock bus: BME280 register file with 400kHz I2C timing
+ */
+class MockBus : public ErriezBMX280Bus
+{
+public:
+    MockBus()
+    {
+        memset(_regs, 0, sizeof(_regs));
+        _regs[BME280_REG_CHIPID] = CHIP_ID_BME280;
+    }
+
+    bool read(uint8_t addr, uint8_t reg, uint8_t *buffer, uint8_t len)
+    {
+        (void)addr;
+
+        // Address + register + address + data, 9 clocks per byte at 400kHz
+        delayMicroseconds(((3 + len) * 9 * 10) / 4);
+        for (uint8_t i = 0; i < len; i++) {
+            buffer[i] = _regs[(uint8_t)(reg + i)];
+        }
+        return true;
+    }
+
+    bool write(uint8_t addr, uint8_t reg, uint8_t value)
+    {
+        (void)addr;
+
+        // Address + register + data
+        delayMicroseconds((3 * 9 * 10) / 4);
+        if (reg != BME280_REG_RESET) {
+            _regs[reg] = value;
+        }
+        return true;
+    }
+
+private:
+    uint8_t _regs[256];
+};
+
+MockBus bus;
+ErriezBMX280 sensors[NUM_SENSORS];
+BMX280_Task_t tasks[NUM_SENSORS];
+
+
+void benchmark(const __FlashStringHelper *name, bool priorities)
+{
+    ErriezBMX280Scheduler scheduler = ErriezBMX280Scheduler(tasks, NUM_SENSORS, NULL);
+    uint16_t loggingMisses = 0;
+    uint32_t start;
+
+    // Critical sensor 50 Hz, logging sensors 45..50 Hz limited to 5% bus time each
+    scheduler.addSensor(&sensors[0], 20, priorities ? 1 : 0);
+    for (uint8_t i = 1; i < NUM_SENSORS; i++) {
+        scheduler.addSensor(&sensors[i], 20 + (i % 3), 0,
+                            priorities ? 50 : BMX280_QUOTA_UNLIMITED);
+    }
+
+    start = millis();
+    while ((millis() - start) < DURATION_MS) {
+        scheduler.run();
+    }
+
+    for (uint8_t i = 1; i < NUM_SENSORS; i++) {
+        loggingMisses += scheduler.getMisses(i);
+    }
+
+    Serial.print(name);
+    Serial.print(F(" | "));
+    Serial.print(scheduler.getMaxLatency(0));
+    Serial.print(F(" us | "));
+    Serial.print(scheduler.getMisses(0));
+    Serial.print(F(" | "));
+    Serial.print(loggingMisses);
+    Serial.print(F(" | "));
+    Serial.print(scheduler.getMaxJitter(0));
+    Serial.print(F(" us | "));
+    Serial.print(scheduler.getLoad() / 10.0F, 1);
+    Serial.print(F(" % | "));
+    Serial.println(scheduler.isFeasible() ? F("Yes") : F("No"));
+}
+
+void setup()
+{
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 bus benchmark"));
+
+    // Initialize sensors on the mock bus
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        sensors[i] = ErriezBMX280(BMX280_I2C_ADDR, &bus);
+        sensors[i].begin();
+        sensors[i].setSampling(BMX280_MODE_FORCED,
+                               BMX280_SAMPLING_X1,
+                               BMX280_SAMPLING_X1,
+                               BMX280_SAMPLING_X1);
+    }
+
+    Serial.println(F("Scheduling     | Critical max latency | Critical misses | Logging misses | Critical max jitter | Load | Feasible"));
+    benchmark(F("EDF            "), false);
+    benchmark(F("Priority+quota "), true);
+}
+
+void loop()
+{
+
+}
@@ -0,0 +1,383 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280DriverBenchmark.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      CPU cycles per driver call on a mock transport without bus delay: register
+ *      access, compensation and float conversion. Awake time per forced mode sample
+ *      with modeled bus and conversion times. No sensor required.
+ *
+ *      The output is a markdown table which can be diffed between commits. Cycles
+ *      are derived from micros() and F_CPU, which is cycle-accurate under a
+ *      simulator, for example:
+ *
+ *          arduino-cli compile -b arduino:avr:uno -e ErriezBMX280DriverBenchmark
+ *          simavr -m atmega328p -f 16000000 build/arduino.avr.uno/ErriezBMX280DriverBenchmark.ino.elf
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <ErriezBMX280.h>
+#include <ErriezBMX280SensorSet.h>
+
+#ifndef F_CPU
+#define F_CPU               16000000UL
+#endif
+
+// Number of calls per measurement
+#define ITERATIONS          1000
+
+// Number of sensors polled by the sensor set
+#define NUM_SENSORS         8
+
+// Number of samples per awake time measurement
+#define AWAKE_ITERATIONS    100
+
+// Modeled timing: one I2C byte at 400 kHz, typical conversion time of X1 T/P/H
+#define MOCK_BYTE_US        23
+#define MOCK_CONVERSION_US  8000
+
+// Sea level for altitude calculation
+#define SEA_LEVEL_PRESSURE_HPA      1026.25
+
+// Typical coefficients, little-endian register layout from 0x88 and 0xE1
+static const uint8_t calibRegs[] = {
+    0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC,                         // T1..T3
+    0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B, 0x27, 0x0B,             // P1..P4
+    0x8C, 0x00, 0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17  // P5..P9
+};
+static const uint8_t calibHumRegs[] = {
+    0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 0x1E                    // H2..H6
+};
+
+// Raw pressure 415148, temperature 519888, humidity 30000
+static const uint8_t dataRegs[] = {
+    0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00, 0x75, 0x30
+};
+
+/*!
+ * \brief Mock bus: BME280 register file without bus delay, optionally with modeled timing
+ */
+class MockBus : public ErriezBMX280Bus
+{
+public:
+    MockBus() : reads(0), writes(0), batching(true), timing(false), _conversionStart(0)
+    {
+        memset(_regs, 0, sizeof(_regs));
+        _regs[BME280_REG_CHIPID] = CHIP_ID_BME280;
+        memcpy(&_regs[BMX280_REG_DIG_T1], calibRegs, sizeof(calibRegs));
+        _regs[BME280_REG_DIG_H1] = 75;
+        memcpy(&_regs[BME280_REG_DIG_H2], calibHumRegs, sizeof(calibHumRegs));
+        memcpy(&_regs[BMX280_REG_PRESS], dataRegs, sizeof(dataRegs));
+    }
+
+    bool read(uint8_t addr, uint8_t reg, uint8_t *buffer, uint8_t len)
+    {
+        (void)addr;
+
+        reads++;
+        if (timing) {
+            // Address write, register, address read, data
+            transfer(3 + len);
+            _regs[BMX280_REG_STATUS] =
+                ((micros() - _conversionStart) < MOCK_CONVERSION_US) ? (1 << STATUS_MEASURING) : 0;
+        }
+        for (uint8_t i = 0; i < len; i++) {
+            buffer[i] = _regs[(uint8_t)(reg + i)];
+        }
+        return true;
+    }
+
+    bool write(uint8_t addr, uint8_t reg, uint8_t value)
+    {
+        (void)addr;
+
+        writes++;
+        if (timing) {
+            transfer(3);
+            if ((reg == BMX280_REG_CTRL_MEAS) && ((value & 0x03) == BMX280_MODE_FORCED)) {
+                _conversionStart = micros();
+            }
+        }
+        if ((reg != BME280_REG_RESET) && (reg < BMX280_REG_PRESS)) {
+            _regs[reg] = value;
+        }
+        return true;
+    }
+
+    bool readBatch(const uint8_t *addrs, uint8_t count, uint8_t reg,
+                   uint8_t *buffer, uint8_t len)
+    {
+        if (!batching) {
+            // One read() per sensor
+            return ErriezBMX280Bus::readBatch(addrs, count, reg, buffer, len);
+        }
+
+        // All sensors in one bus transfer
+        reads++;
+        for (uint8_t i = 0; i < count; i++) {
+            memcpy(&buffer[i * len], &_regs[reg], len);
+        }
+        return true;
+    }
+
+    uint32_t reads;
+    uint32_t writes;
+    bool batching;
+    bool timing;
+
+private:
+    uint8_t _regs[256];
+    uint32_t _conversionStart;
+
+    void transfer(uint8_t bytes)
+    {
+        uint32_t start = micros();
+
+        while ((micros() - start) < ((uint32_t)bytes * MOCK_BYTE_US)) {
+            ;
+        }
+    }
+};
+
+MockBus bus;
+ErriezBMX280 bmx280 = ErriezBMX280(BMX280_I2C_ADDR, &bus);
+ErriezBMX280SensorSet<NUM_SENSORS> sensors;
+
+// Keep results to prevent the compiler from removing the calls
+volatile float sink;
+
+// Measurement start
+uint32_t startTime;
+uint32_t startReads;
+
+
+void start()
+{
+    startReads = bus.reads;
+    startTime = micros();
+}
+
+void printRow(const __FlashStringHelper *name)
+{
+    uint32_t us = micros() - startTime;
+
+    Serial.print(F("| "));
+    Serial.print(name);
+    Serial.print(F(" | "));
+    Serial.print((uint32_t)(((uint64_t)us * (F_CPU / 1000000UL)) / ITERATIONS));
+    Serial.print(F(" | "));
+    Serial.print((float)(bus.reads - startReads) / ITERATIONS);
+    Serial.println(F(" |"));
+}
+
+void benchmarkReads(const __FlashStringHelper *title, uint16_t windowMs)
+{
+    bmx280.setCoalescingWindow(windowMs);
+
+    Serial.println(title);
+    Serial.println(F("| Call | Cycles/call | Bus reads/call |"));
+    Serial.println(F("| --- | --- | --- |"));
+
+    start();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280.readTemperature();
+    }
+    printRow(F("readTemperature()"));
+
+    start();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280.readPressure();
+    }
+    printRow(F("readPressure()"));
+
+    start();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280.readHumidity();
+    }
+    printRow(F("readHumidity()"));
+
+    start();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink = bmx280.readAltitude(SEA_LEVEL_PRESSURE_HPA);
+    }
+    printRow(F("readAltitude()"));
+
+    Serial.println();
+}
+
+void benchmarkSample()
+{
+    Serial.println(F("Burst read, ErriezBMX280Sample"));
+    Serial.println(F("| Call | Cycles/call | Bus reads/call |"));
+    Serial.println(F("| --- | --- | --- |"));
+
+    start();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        ErriezBMX280Sample sample = bmx280.readAll();
+        sink = sample.getTemperature();
+    }
+    printRow(F("readAll() + getTemperature()"));
+
+    start();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        ErriezBMX280Sample sample = bmx280.readAll();
+        sink = sample.getTemperature() + sample.getPressure() +
+               sample.getHumidity() + sample.getAltitude(SEA_LEVEL_PRESSURE_HPA);
+    }
+    printRow(F("readAll() + all getters"));
+
+    Serial.println();
+}
+
+void benchmarkSensorSet()
+{
+    // Sensors on the mock bus
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        sensors.add(BMX280_I2C_ADDR, &bus);
+    }
+    sensors.begin();
+
+    Serial.println(F("Sensor set, 8 sensors on one bus"));
+    Serial.println(F("| Call | Cycles/call | Bus reads/call |"));
+    Serial.println(F("| --- | --- | --- |"));
+
+    bus.batching = false;
+    start();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sensors.poll();
+    }
+    printRow(F("poll(), per-sensor reads"));
+
+    bus.batching = true;
+    start();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sensors.poll();
+    }
+    printRow(F("poll(), batched read"));
+
+    Serial.println();
+}
+
+void printAwakeRow(const __FlashStringHelper *name, uint32_t startTransactions)
+{
+    uint32_t us = micros() - startTime;
+
+    Serial.print(F("| "));
+    Serial.print(name);
+    Serial.print(F(" | "));
+    Serial.print(us / AWAKE_ITERATIONS);
+    Serial.print(F(" | "));
+    Serial.print((float)(bus.reads + bus.writes - startTransactions) / AWAKE_ITERATIONS);
+    Serial.println(F(" |"));
+}
+
+void benchmarkAwakeTime()
+{
+    uint32_t transactions;
+
+    Serial.println(F("Forced mode awake time, X1 sampling, modeled 400 kHz I2C and conversion"));
+    Serial.println(F("| Sequence | Awake time us/sample | Bus transactions/sample |"));
+    Serial.println(F("| --- | --- | --- |"));
+
+    bus.timing = true;
+
+    transactions = bus.reads + bus.writes;
+    startTime = micros();
+    for (uint16_t i = 0; i < AWAKE_ITERATIONS; i++) {
+        bmx280.setSampling(BMX280_MODE_FORCED,
+                           BMX280_SAMPLING_X1,
+                           BMX280_SAMPLING_X1,
+                           BMX280_SAMPLING_X1,
+                           BMX280_FILTER_OFF,
+                           BMX280_STANDBY_MS_0_5);
+        delay((bmx280.getConversionTime() + 999) / 1000);
+        sink = bmx280.readTemperature() + bmx280.readPressure() + bmx280.readHumidity();
+    }
+    printAwakeRow(F("setSampling() + delay() + readX() x3"), transactions);
+
+    // First samples learn the conversion time of the modeled chip
+    for (uint16_t i = 0; i < (3 * AWAKE_ITERATIONS); i++) {
+        bmx280.measureOnce();
+    }
+
+    transactions = bus.reads + bus.writes;
+    startTime = micros();
+    for (uint16_t i = 0; i < AWAKE_ITERATIONS; i++) {
+        ErriezBMX280Sample sample = bmx280.measureOnce();
+        sink = sample.getTemperature() + sample.getPressure() + sample.getHumidity();
+    }
+    printAwakeRow(F("measureOnce() + getters"), transactions);
+
+    bus.timing = false;
+
+    Serial.println();
+}
+
+void setup()
+{
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 driver benchmark"));
+    Serial.print(F("F_CPU: "));
+    Serial.println(F_CPU);
+    Serial.println();
+
+    // Initialize sensor on the mock bus
+    if (!bmx280.begin()) {
+        Serial.println(F("Error: Could not detect sensor"));
+        return;
+    }
+    bmx280.setSampling(BMX280_MODE_NORMAL,
+                       BMX280_SAMPLING_X1,
+                       BMX280_SAMPLING_X1,
+                       BMX280_SAMPLING_X1,
+                       BMX280_FILTER_OFF,
+                       BMX280_STANDBY_MS_0_5);
+
+    // Sanity check of the mock: 25.08 degree Celsius
+    Serial.print(F("Temperature: "));
+    Serial.println(bmx280.readTemperature());
+    Serial.println();
+
+    benchmarkReads(F("Per-register reads"), 0);
+    benchmarkReads(F("Request coalescing 1000ms"), 1000);
+    bmx280.setCoalescingWindow(0);
+    benchmarkSample();
+    benchmarkSensorSet();
+    benchmarkAwakeTime();
+}
+
+void loop()
+{
+
+}
@@ -0,0 +1,232 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/*!
+ * \file ErriezBMX280IngestBenchmark.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Gateway ingest throughput with a synthetic load of sensor nodes: frames with
+ *      duplicates and reordering are queued, decoded, deduplicated, compensated and
+ *      archived. Only the pipeline is timed, on one core. No sensor required.
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <ErriezBMX280Ingest.h>
+
+// Number of nodes, queue slots and archive size in RAM
+#if defined(ARDUINO_ARCH_AVR)
+#define NUM_NODES           16
+#define QUEUE_SLOTS         16
+#define ARCHIVE_SIZE        512
+#else
+#define NUM_NODES           1024
+#define QUEUE_SLOTS         256
+#define ARCHIVE_SIZE        8192
+#endif
+
+// Number of generated frames
+#define FRAMES              20000UL
+
+// Chunk size and samples per chunk of the archive of node 0
+#define CHUNK_SIZE          256
+#define CHUNK_SAMPLES       32
+
+// Typical coefficients, nodes use one of two sets
+static const BMX280_Calib_t calib[2] = {
+    {
+        27504, 26435, -1000,
+        36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+        75, 362, 0, 313, 50, 30
+    },
+    {
+        28009, 25654, 50,
+        36670, -10531, 3024, 5591, -54, -7, 12300, -12000, 5000,
+        75, 355, 0, 338, 0, 30
+    }
+};
+
+/*!
+ * \brief RAM storage
+ */
+class RamStorage : public ErriezBMX280Storage
+{
+public:
+    bool read(uint32_t addr, uint8_t *buffer, uint16_t len)
+    {
+        memcpy(buffer, &_mem[addr], len);
+        return true;
+    }
+
+    bool write(uint32_t addr, const uint8_t *buffer, uint16_t len)
+    {
+        memcpy(&_mem[addr], buffer, len);
+        return true;
+    }
+
+    uint32_t size()
+    {
+        return sizeof(_mem);
+    }
+
+private:
+    uint8_t _mem[ARCHIVE_SIZE];
+};
+
+RamStorage storage;
+BMX280_ArchiveSample_t samples[CHUNK_SAMPLES];
+ErriezBMX280Archive archive = ErriezBMX280Archive(&storage, samples, CHUNK_SAMPLES, CHUNK_SIZE);
+
+BMX280_IngestFrame_t slots[QUEUE_SLOTS];
+ErriezBMX280FrameQueue queue = ErriezBMX280FrameQueue(slots, QUEUE_SLOTS);
+
+BMX280_IngestNode_t nodes[NUM_NODES];
+ErriezBMX280Ingest ingest = ErriezBMX280Ingest(&queue, nodes, NUM_NODES);
+
+// Load generator state
+uint16_t nodeSequence[NUM_NODES];
+uint32_t seed = 1;
+uint32_t timestamp;
+BMX280_IngestFrame_t delayed;
+bool hasDelayed;
+
+
+uint16_t random16()
+{
+    seed = seed * 1103515245UL + 12345;
+    return seed >> 16;
+}
+
+void sendFrame(const BMX280_IngestFrame_t *frame)
+{
+    queue.push((const uint8_t *)frame, BMX280_INGEST_FRAME_LEN);
+}
+
+void generateFrame()
+{
+    BMX280_LogRecord_t record;
+    BMX280_IngestFrame_t frame;
+    BMX280_Raw_t raw;
+    uint16_t node = random16() % NUM_NODES;
+    uint16_t r = random16();
+
+    raw.adc_T = 519888L + (int16_t)(r & 0x3FF) - 512;
+    raw.adc_P = 415148L + (int16_t)((r >> 4) & 0x3FF) - 512;
+    raw.adc_H = 30000 + (r & 0xFF);
+
+    bmx280LogRecordPack(&record, raw, true, timestamp++, nodeSequence[node]++);
+    bmx280IngestFramePack(&frame, 1000 + node, &record);
+
+    // 1/8 of the frames is sent twice, 1/16 is delayed by one frame
+    if ((r & 0x0F) == 0) {
+        if (hasDelayed) {
+            sendFrame(&delayed);
+        }
+        delayed = frame;
+        hasDelayed = true;
+        return;
+    }
+    sendFrame(&frame);
+    if ((r & 0x70) == 0) {
+        sendFrame(&frame);
+    }
+    if (hasDelayed) {
+        sendFrame(&delayed);
+        hasDelayed = false;
+    }
+}
+
+void setup()
+{
+    const BMX280_IngestStats_t *stats;
+    uint32_t generated = 0;
+    uint32_t us = 0;
+
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 ingest benchmark"));
+
+    if (!archive.begin() || !archive.format()) {
+        Serial.println(F("Error: Archive too small"));
+        return;
+    }
+    for (uint16_t node = 0; node < NUM_NODES; node++) {
+        ingest.addNode(1000 + node, &calib[node & 1], (node == 0) ? &archive : NULL);
+        nodeSequence[node] = random16();
+    }
+
+    while (generated < FRAMES) {
+        uint32_t start;
+
+        // Fill the queue, leaving room for duplicates
+        while ((queue.count() < (QUEUE_SLOTS - 4)) && (generated < FRAMES)) {
+            generateFrame();
+            generated++;
+        }
+
+        start = micros();
+        ingest.process(QUEUE_SLOTS);
+        us += micros() - start;
+    }
+
+    stats = ingest.getStats();
+    Serial.print(F("Nodes: "));
+    Serial.print(NUM_NODES);
+    Serial.print(F(", queue slots: "));
+    Serial.println(QUEUE_SLOTS);
+    Serial.println();
+
+    Serial.println(F("| Frames | Duplicates | Late | Written | Rejected | Archived (node 0) | us | Frames/s |"));
+    Serial.println(F("| --- | --- | --- | --- | --- | --- | --- | --- |"));
+    Serial.print(F("| "));
+    Serial.print(stats->frames);
+    Serial.print(F(" | "));
+    Serial.print(stats->duplicates);
+    Serial.print(F(" | "));
+    Serial.print(stats->late);
+    Serial.print(F(" | "));
+    Serial.print(stats->written);
+    Serial.print(F(" | "));
+    Serial.print(stats->rejected);
+    Serial.print(F(" | "));
+    Serial.print(archive.count());
+    Serial.print(F(" | "));
+    Serial.print(us);
+    Serial.print(F(" | "));
+    Serial.print(us ? (uint32_t)((uint64_t)stats->frames * 1000000UL / us) : 0);
+    Serial.println(F(" |"));
+    Serial.println();
+}
+
+void loop()
+{
+
+}
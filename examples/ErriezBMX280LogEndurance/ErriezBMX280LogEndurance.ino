@@ -0,0 +1,196 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/*!
+ * \file ErriezBMX280LogEndurance.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Write cycles per EEPROM cell after N records in RAM storage with wear counters:
+ *      a float overwritten in place, the circular log and the page log. On byte
+ *      writable EEPROM both logs spread the writes over all cells, the page log adds
+ *      a header per page and is meant for memories written or erased per page. No
+ *      sensor required.
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <ErriezBMX280Log.h>
+#include <ErriezBMX280PageLog.h>
+#include <ErriezBMX280RamStorage.h>
+
+// Log region size and page size
+#if defined(ARDUINO_ARCH_AVR)
+#define REGION_SIZE         256
+#define PAGE_SIZE           64
+#else
+#define REGION_SIZE         4096
+#define PAGE_SIZE           128
+#endif
+
+// Number of records
+#define RECORDS             10000U
+
+// Write cycles of an EEPROM cell
+#define CELL_ENDURANCE      100000UL
+
+// Records per year at one record per minute
+#define RECORDS_PER_YEAR    525600UL
+
+// Typical coefficients
+static const BMX280_Calib_t calib = {
+    27504, 26435, -1000,
+    36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+    75, 362, 0, 313, 50, 30
+};
+
+// Memory and write counter per cell
+uint8_t mem[REGION_SIZE];
+uint16_t cellWrites[REGION_SIZE];
+uint8_t pageBuffer[PAGE_SIZE];
+
+// Sample generator state
+uint32_t seed;
+BMX280_Raw_t raw;
+
+
+ErriezBMX280Sample nextSample()
+{
+    seed = seed * 1103515245UL + 12345;
+    raw.adc_T += (int8_t)((seed >> 16) % 7) - 3;
+    raw.adc_P += (int8_t)((seed >> 8) % 31) - 15;
+    raw.adc_H += (int8_t)((seed >> 20) % 5) - 2;
+
+    return ErriezBMX280Sample(&calib, raw, true);
+}
+
+void resetSamples()
+{
+    seed = 1;
+    raw.adc_T = 519888;
+    raw.adc_P = 415148;
+    raw.adc_H = 30000;
+}
+
+void printRow(const __FlashStringHelper *name, ErriezBMX280RamStorage &storage)
+{
+    uint32_t sum = 0;
+    uint16_t max = 0;
+
+    for (uint32_t addr = 0; addr < REGION_SIZE; addr++) {
+        uint16_t writes = storage.getCellWrites(addr);
+
+        sum += writes;
+        if (writes > max) {
+            max = writes;
+        }
+    }
+
+    Serial.print(F("| "));
+    Serial.print(name);
+    Serial.print(F(" | "));
+    Serial.print(max);
+    Serial.print(F(" | "));
+    Serial.print((float)sum / REGION_SIZE);
+    Serial.print(F(" | "));
+    Serial.print(max ? ((float)RECORDS * CELL_ENDURANCE / max / RECORDS_PER_YEAR) : 0);
+    Serial.println(F(" |"));
+}
+
+void benchmarkInPlace()
+{
+    ErriezBMX280RamStorage storage(mem, REGION_SIZE, cellWrites);
+
+    resetSamples();
+    for (uint16_t i = 0; i < RECORDS; i++) {
+        float pressure = nextSample().getPressure();
+
+        storage.write(0, (const uint8_t *)&pressure, sizeof(pressure));
+    }
+    printRow(F("Float in place"), storage);
+}
+
+void benchmarkLog()
+{
+    ErriezBMX280RamStorage storage(mem, REGION_SIZE, cellWrites);
+    ErriezBMX280Log logger(&storage);
+
+    if (!logger.begin()) {
+        Serial.println(F("Error: Log region too small"));
+        return;
+    }
+    resetSamples();
+    for (uint16_t i = 0; i < RECORDS; i++) {
+        logger.append(nextSample(), i);
+    }
+    printRow(F("ErriezBMX280Log"), storage);
+}
+
+void benchmarkPageLog()
+{
+    ErriezBMX280RamStorage storage(mem, REGION_SIZE, cellWrites);
+    ErriezBMX280PageLog logger(&storage, pageBuffer, PAGE_SIZE);
+
+    if (!logger.begin()) {
+        Serial.println(F("Error: Page log region too small"));
+        return;
+    }
+    resetSamples();
+    for (uint16_t i = 0; i < RECORDS; i++) {
+        logger.append(nextSample(), i);
+    }
+    logger.flush();
+    printRow(F("ErriezBMX280PageLog"), storage);
+}
+
+void setup()
+{
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 log endurance benchmark"));
+
+    Serial.print(RECORDS);
+    Serial.print(F(" records, "));
+    Serial.print(REGION_SIZE);
+    Serial.println(F(" bytes EEPROM"));
+    Serial.println();
+
+    Serial.println(F("| Writer | Max writes/cell | Mean writes/cell | Years at 1 record/min |"));
+    Serial.println(F("| --- | --- | --- | --- |"));
+    benchmarkInPlace();
+    benchmarkLog();
+    benchmarkPageLog();
+    Serial.println();
+}
+
+void loop()
+{
+
+}
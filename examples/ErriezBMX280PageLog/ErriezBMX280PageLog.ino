@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/*!
+ * \file ErriezBMX280PageLog.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Log raw samples to EEPROM one page at a time, wear-leveled over all pages
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <Wire.h>
+#include <EEPROM.h>
+#include <ErriezBMX280.h>
+#include <ErriezBMX280PageLog.h>
+#include <ErriezBMX280EEPROM.h>
+
+// Log interval
+#define INTERVAL_MS         60000
+
+// Page size: header and 7 records
+#define PAGE_SIZE           128
+
+// Create BMX280 object I2C address 0x76
+ErriezBMX280 bmx280 = ErriezBMX280(0x76);
+
+// Create page log in the complete EEPROM
+ErriezBMX280EEPROM storage;
+uint8_t pageBuffer[PAGE_SIZE];
+ErriezBMX280PageLog logger = ErriezBMX280PageLog(&storage, pageBuffer, PAGE_SIZE);
+
+// Time of last sample
+uint32_t lastSample;
+
+
+void setup()
+{
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 page log example"));
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+    // EEPROM emulation in flash
+    EEPROM.begin(1024);
+#endif
+
+    // Initialize I2C bus
+    Wire.begin();
+    Wire.setClock(400000);
+
+    // Initialize sensor
+    while (!bmx280.begin()) {
+        Serial.println(F("Error: Could not detect sensor"));
+        delay(3000);
+    }
+
+    // Find the newest page, call logger.format() once for an EEPROM holding other data
+    if (!logger.begin()) {
+        Serial.println(F("Error: EEPROM too small"));
+    }
+
+    // Print records logged before reset or power loss, oldest first
+    Serial.print(F("Records: "));
+    Serial.print(logger.count());
+    Serial.print(F(" of "));
+    Serial.println(logger.capacity());
+    for (uint32_t age = logger.count(); age > 0; age--) {
+        BMX280_LogRecord_t record;
+
+        if (logger.read(age - 1, &record)) {
+            ErriezBMX280Sample sample = bmx280LogRecordSample(&record, bmx280.getCalib());
+
+            Serial.print(record.timestamp);
+            Serial.print(F(": "));
+            Serial.print(sample.getTemperature());
+            Serial.print(F(" C, "));
+            Serial.print(sample.getPressure() / 100.0F);
+            Serial.println(F(" hPa"));
+        }
+    }
+
+    lastSample = millis();
+}
+
+void loop()
+{
+    // Log once per interval, timestamp in seconds since reset
+    if ((millis() - lastSample) >= INTERVAL_MS) {
+        lastSample += INTERVAL_MS;
+        logger.append(bmx280.readAll(), lastSample / 1000);
+
+        // A page is written every 7 records
+        Serial.print(F("Buffered: "));
+        Serial.print(logger.pending());
+        Serial.print(F(", page writes: "));
+        Serial.println(logger.getPageWrites());
+    }
+
+    // Write buffered records before a planned power down, for example with a button:
+    // logger.flush();
+}
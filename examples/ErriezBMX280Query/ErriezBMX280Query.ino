@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Query.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Keep a history of two sensors in RAM and answer binary queries via Serial
+ *      without bus access. See ErriezBMX280Query.h for the protocol.
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <Wire.h>
+#include <ErriezBMX280.h>
+#include <ErriezBMX280Query.h>
+
+// Number of samples per sensor
+#define HISTORY_SIZE        32
+
+// Sample interval
+#define INTERVAL_MS         1000
+
+// Create BMX280 objects I2C address 0x76 and 0x77
+ErriezBMX280 sensors[2] = {
+    ErriezBMX280(0x76),
+    ErriezBMX280(0x77)
+};
+
+// History storage, one per sensor
+BMX280_HistoryEntry_t entries0[HISTORY_SIZE];
+BMX280_HistoryEntry_t entries1[HISTORY_SIZE];
+ErriezBMX280History history0 = ErriezBMX280History(entries0, HISTORY_SIZE);
+ErriezBMX280History history1 = ErriezBMX280History(entries1, HISTORY_SIZE);
+ErriezBMX280History *histories[2] = { &history0, &history1 };
+
+// Create query server, sensor mask bit 0 = 0x76, bit 1 = 0x77
+ErriezBMX280QueryServer server = ErriezBMX280QueryServer(histories, 2);
+
+// Time of last sample
+uint32_t lastSample;
+
+
+void setup()
+{
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+
+    // Initialize I2C bus
+    Wire.begin();
+    Wire.setClock(400000);
+
+    // Initialize sensors, not detected sensors answer without records
+    for (uint8_t i = 0; i < 2; i++) {
+        sensors[i].begin();
+    }
+
+    lastSample = millis();
+}
+
+void loop()
+{
+    // Sample all sensors once per interval
+    if ((millis() - lastSample) >= INTERVAL_MS) {
+        lastSample += INTERVAL_MS;
+        for (uint8_t i = 0; i < 2; i++) {
+            histories[i]->add(sensors[i].readAll());
+        }
+    }
+
+    // Answer queries from the histories in RAM
+    server.poll(Serial);
+}
@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/*!
+ * \file ErriezBMX280Rollup.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Aggregate one sample per second into minute and hour buckets
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <Wire.h>
+#include <ErriezBMX280.h>
+#include <ErriezBMX280Rollup.h>
+
+// Create BMX280 object I2C address 0x76
+ErriezBMX280 bmx280 = ErriezBMX280(0x76);
+
+// Rollup levels: 1 s, 1 min, 1 h
+BMX280_RollupLevel_t levels[3];
+ErriezBMX280Rollup rollup = ErriezBMX280Rollup(levels, 3);
+
+
+void printBucket(const __FlashStringHelper *name, const BMX280_RollupBucket_t *bucket)
+{
+    const BMX280_Aggregate_t *t = &bucket->channel[BMX280_ROLLUP_TEMPERATURE];
+    const BMX280_Aggregate_t *p = &bucket->channel[BMX280_ROLLUP_PRESSURE];
+
+    Serial.print(name);
+    Serial.print(bucket->start);
+    Serial.print(F(": "));
+    Serial.print(t->min / 100.0);
+    Serial.print(F(" .. "));
+    Serial.print(bmx280AggregateMean(t) / 100.0);
+    Serial.print(F(" .. "));
+    Serial.print(t->max / 100.0);
+    Serial.print(F(" C, "));
+    Serial.print(bmx280AggregateMean(p) / 100.0);
+    Serial.print(F(" hPa +/- "));
+    Serial.print(sqrt(bmx280AggregateVariance(p)));
+    Serial.print(F(" Pa, samples "));
+    Serial.println(t->count);
+}
+
+void setup()
+{
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 rollup example"));
+
+    // Initialize I2C bus
+    Wire.begin();
+    Wire.setClock(400000);
+
+    // Initialize sensor
+    while (!bmx280.begin()) {
+        Serial.println(F("Error: Could not detect sensor"));
+        delay(3000);
+    }
+
+    // Durations in seconds, in level order
+    rollup.setDuration(0, 1);
+    rollup.setDuration(1, 60);
+    rollup.setDuration(2, 3600);
+}
+
+void loop()
+{
+    // Endless stream of one sample per second, timestamp in seconds since reset
+    for (ErriezBMX280Sample &sample : bmx280.stream(1000)) {
+        uint8_t completed = rollup.add(sample, millis() / 1000);
+
+        if (completed & (1 << 1)) {
+            printBucket(F("Minute "), rollup.getBucket(1));
+        }
+        if (completed & (1 << 2)) {
+            printBucket(F("Hour "), rollup.getBucket(2));
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280SPI.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Read several sensors on one SPI bus with one batched SPI transaction
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <SPI.h>
+#include <ErriezBMX280.h>
+#include <ErriezBMX280SPI.h>
+
+// Number of sensors
+#define NUM_SENSORS         2
+
+// Chip select pins
+const uint8_t csPins[NUM_SENSORS] = { 10, 9 };
+
+// SPI bus interface
+ErriezBMX280SPI spiBus = ErriezBMX280SPI(SPI);
+
+// Create BMX280 objects, device address is the chip select pin
+ErriezBMX280 sensors[NUM_SENSORS] = {
+    ErriezBMX280(csPins[0], &spiBus),
+    ErriezBMX280(csPins[1], &spiBus)
+};
+
+// Data registers of all sensors
+uint8_t data[NUM_SENSORS * BME280_DATA_LEN];
+
+
+void setup()
+{
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 SPI example"));
+
+    // Initialize SPI bus and chip select pins before the sensors
+    spiBus.begin();
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        spiBus.beginDevice(csPins[i]);
+    }
+
+    // Initialize sensors
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        while (!sensors[i].begin()) {
+            Serial.print(F("Error: Could not detect sensor "));
+            Serial.println(i);
+            delay(3000);
+        }
+    }
+}
+
+void loop()
+{
+    // All sensors have the same chip type: BMP280 and BME280 need different lengths
+    uint8_t len = sensors[0].getDataLength();
+
+    // Burst read the data registers of all sensors in one SPI transaction
+    if (!spiBus.readBatch(csPins, NUM_SENSORS, BMX280_REG_PRESS, data, len)) {
+        Serial.println(F("Error: SPI read failed"));
+        delay(1000);
+        return;
+    }
+
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        ErriezBMX280Sample sample = sensors[i].decode(&data[i * len]);
+
+        Serial.print(i);
+        Serial.print(F(": "));
+        Serial.print(sample.getTemperature());
+        Serial.print(F(" C, "));
+        Serial.print(sample.getPressure() / 100.0F);
+        Serial.print(F(" hPa"));
+        if (sample.hasHumidity()) {
+            Serial.print(F(", "));
+            Serial.print(sample.getHumidity());
+            Serial.print(F(" %"));
+        }
+        Serial.println();
+    }
+
+    delay(1000);
+}
@@ -0,0 +1,279 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/*!
+ * \file ErriezBMX280SPIBenchmark.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      SPI transactions, chip select frames and bytes per poll of several sensors:
+ *      per-sensor reads against one batched read. Sensors are emulated by a mock SPI
+ *      bus with one BME280 register file per chip select pin and the SPI address
+ *      format of the sensor. No sensor required.
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <ErriezBMX280.h>
+#include <ErriezBMX280SPI.h>
+
+// Number of sensors
+#define NUM_SENSORS         4
+
+// Number of polls per measurement
+#define ITERATIONS          100
+
+// Typical coefficients, little-endian register layout from 0x88 and 0xE1
+static const uint8_t calibRegs[] = {
+    0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC,                         // T1..T3
+    0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B, 0x27, 0x0B,             // P1..P4
+    0x8C, 0x00, 0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17  // P5..P9
+};
+static const uint8_t calibHumRegs[] = {
+    0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 0x1E                    // H2..H6
+};
+
+// Raw pressure 415148, temperature 519888, humidity 30000
+static const uint8_t dataRegs[] = {
+    0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00, 0x75, 0x30
+};
+
+// Chip select pins
+const uint8_t csPins[NUM_SENSORS] = { 10, 9, 8, 7 };
+
+/*!
+ * \brief Mock SPI bus: BME280 register files addressed by chip select pin
+ * \details
+ *      Models the SPI frames of ErriezBMX280SPI: one SPI transaction per read() and
+ *      write(), one for all sensors of readBatch(). Each chip select frame starts with
+ *      the address byte: bit 7 set to read, cleared to write, the sensor sets bit 7
+ *      again to address its registers.
+ */
+class MockSPIBus : public ErriezBMX280Bus
+{
+public:
+    MockSPIBus() : transactions(0), frames(0), bytes(0)
+    {
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            uint8_t *regs = _regs[i];
+
+            memset(regs, 0, sizeof(_regs[i]));
+            regs[BME280_REG_CHIPID] = CHIP_ID_BME280;
+            memcpy(&regs[BMX280_REG_DIG_T1], calibRegs, sizeof(calibRegs));
+            regs[BME280_REG_DIG_H1] = 75;
+            memcpy(&regs[BME280_REG_DIG_H2], calibHumRegs, sizeof(calibHumRegs));
+            memcpy(&regs[BMX280_REG_PRESS], dataRegs, sizeof(dataRegs));
+
+            // Temperature MSB differs per sensor to check the order of batched data
+            regs[BMX280_REG_TEMP] += i;
+        }
+    }
+
+    bool read(uint8_t csPin, uint8_t reg, uint8_t *buffer, uint8_t len)
+    {
+        transactions++;
+        return frame(csPin, reg | BMX280_SPI_READ, buffer, len);
+    }
+
+    bool write(uint8_t csPin, uint8_t reg, uint8_t value)
+    {
+        transactions++;
+        return frame(csPin, reg & ~BMX280_SPI_READ, &value, 1);
+    }
+
+    bool readBatch(const uint8_t *csPins, uint8_t count, uint8_t reg,
+                   uint8_t *buffer, uint8_t len)
+    {
+        // One transaction, chip select toggles between the sensors
+        transactions++;
+        for (uint8_t i = 0; i < count; i++) {
+            if (!frame(csPins[i], reg | BMX280_SPI_READ, &buffer[i * len], len)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint32_t transactions;
+    uint32_t frames;
+    uint32_t bytes;
+
+private:
+    uint8_t _regs[NUM_SENSORS][256];
+
+    bool frame(uint8_t csPin, uint8_t addr, uint8_t *data, uint8_t len)
+    {
+        uint8_t *regs = NULL;
+        uint8_t reg = addr | BMX280_SPI_READ;
+
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            if (csPins[i] == csPin) {
+                regs = _regs[i];
+            }
+        }
+        if (regs == NULL) {
+            return false;
+        }
+
+        frames++;
+        bytes += 1 + len;
+
+        if (addr & BMX280_SPI_READ) {
+            // Auto-increment of the register address during a burst read
+            for (uint8_t i = 0; i < len; i++) {
+                data[i] = regs[(uint8_t)(reg + i)];
+            }
+        } else if ((reg != BME280_REG_RESET) && (reg < BMX280_REG_PRESS)) {
+            regs[reg] = data[0];
+        }
+        return true;
+    }
+};
+
+MockSPIBus bus;
+
+// Create BMX280 objects, device address is the chip select pin
+ErriezBMX280 sensors[NUM_SENSORS] = {
+    ErriezBMX280(csPins[0], &bus),
+    ErriezBMX280(csPins[1], &bus),
+    ErriezBMX280(csPins[2], &bus),
+    ErriezBMX280(csPins[3], &bus)
+};
+
+// Data registers of all sensors
+uint8_t data[NUM_SENSORS * BME280_DATA_LEN];
+
+// Temperatures of the per-sensor reads
+int32_t temperatures[NUM_SENSORS];
+
+// Measurement start
+uint32_t startTransactions;
+uint32_t startFrames;
+uint32_t startBytes;
+
+
+void start()
+{
+    startTransactions = bus.transactions;
+    startFrames = bus.frames;
+    startBytes = bus.bytes;
+}
+
+void printRow(const __FlashStringHelper *name)
+{
+    Serial.print(F("| "));
+    Serial.print(name);
+    Serial.print(F(" | "));
+    Serial.print((float)(bus.transactions - startTransactions) / ITERATIONS);
+    Serial.print(F(" | "));
+    Serial.print((float)(bus.frames - startFrames) / ITERATIONS);
+    Serial.print(F(" | "));
+    Serial.print((float)(bus.bytes - startBytes) / ITERATIONS);
+    Serial.println(F(" |"));
+}
+
+bool pollPerSensor()
+{
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        ErriezBMX280Sample sample = sensors[i].readAll();
+
+        if (!sample.isValid()) {
+            return false;
+        }
+        temperatures[i] = sample.getTemperatureNative();
+    }
+    return true;
+}
+
+bool pollBatched(bool *match)
+{
+    uint8_t len = sensors[0].getDataLength();
+
+    if (!bus.readBatch(csPins, NUM_SENSORS, BMX280_REG_PRESS, data, len)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        ErriezBMX280Sample sample = sensors[i].decode(&data[i * len]);
+
+        if (sample.getTemperatureNative() != temperatures[i]) {
+            *match = false;
+        }
+    }
+    return true;
+}
+
+void setup()
+{
+    bool match = true;
+
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 SPI benchmark"));
+
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        if (!sensors[i].begin()) {
+            Serial.print(F("Error: Could not detect sensor "));
+            Serial.println(i);
+            return;
+        }
+    }
+
+    Serial.print(NUM_SENSORS);
+    Serial.println(F(" BME280 sensors on one SPI bus, per poll:"));
+    Serial.println(F("| Read | SPI transactions | Chip select frames | Bytes |"));
+    Serial.println(F("| --- | --- | --- | --- |"));
+
+    start();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        pollPerSensor();
+    }
+    printRow(F("readAll() per sensor"));
+
+    start();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        pollBatched(&match);
+    }
+    printRow(F("readBatch() + decode()"));
+    Serial.println();
+
+    Serial.print(F("Batched temperatures equal per-sensor reads: "));
+    Serial.println(match ? F("yes") : F("no"));
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        Serial.print(i);
+        Serial.print(F(": "));
+        Serial.print(temperatures[i] / 100.0);
+        Serial.println(F(" C"));
+    }
+}
+
+void loop()
+{
+
+}
@@ -0,0 +1,106 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Scheduler.ino
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Sample two sensors on one I2C bus at different rates without delay()
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include <Wire.h>
+#include <ErriezBMX280.h>
+#include <ErriezBMX280Scheduler.h>
+
+// Create BMX280 objects I2C address 0x76 and 0x77
+ErriezBMX280 bmx280Fast = ErriezBMX280(0x76);
+ErriezBMX280 bmx280Slow = ErriezBMX280(0x77);
+
+// Scheduler task storage, one task per sensor
+BMX280_Task_t tasks[2];
+
+// Called by the scheduler for each sample
+void onSample(uint8_t task, ErriezBMX280Sample &sample);
+
+// Create scheduler
+ErriezBMX280Scheduler scheduler = ErriezBMX280Scheduler(tasks, 2, onSample);
+
+
+void setup()
+{
+    // Initialize serial
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez BMP280/BMX280 scheduler example"));
+
+    // Initialize I2C bus
+    Wire.begin();
+    Wire.setClock(400000);
+
+    // Initialize sensors
+    while (!bmx280Fast.begin() || !bmx280Slow.begin()) {
+        Serial.println(F("Error: Could not detect sensors"));
+        delay(3000);
+    }
+
+    // Forced mode: the scheduler starts a conversion once per period
+    bmx280Fast.setSampling(BMX280_MODE_FORCED,
+                           BMX280_SAMPLING_X1,
+                           BMX280_SAMPLING_X4,
+                           BMX280_SAMPLING_NONE);
+    bmx280Slow.setSampling(BMX280_MODE_FORCED,
+                           BMX280_SAMPLING_X1,
+                           BMX280_SAMPLING_X1,
+                           BMX280_SAMPLING_X1);
+
+    // 50 Hz and 1 Hz
+    scheduler.addSensor(&bmx280Fast, 20);
+    scheduler.addSensor(&bmx280Slow, 1000);
+}
+
+void loop()
+{
+    // Non-blocking: performs at most one bus transaction
+    scheduler.run();
+}
+
+void onSample(uint8_t task, ErriezBMX280Sample &sample)
+{
+    if (task == 1) {
+        Serial.print(F("Temperature: "));
+        Serial.print(sample.getTemperature());
+        Serial.println(" C");
+
+        Serial.print(F("Misses:      "));
+        Serial.print(scheduler.getMisses(0));
+        Serial.print(F(" / "));
+        Serial.println(scheduler.getMisses(1));
+    }
+}
@@ -39,10 +39,21 @@
  * \brief Constructor
  * \param i2cAddr
  *      I2C address
+ * \param bus
+ *      Bus interface, NULL = Wire
  */
-ErriezBMX280::ErriezBMX280(uint8_t i2cAddr) : _i2cAddr(i2cAddr), _t_fine(0)
+ErriezBMX280::ErriezBMX280(uint8_t i2cAddr, ErriezBMX280Bus *bus) :
+    _i2cAddr(i2cAddr), _bus(bus), _t_fine(0), _ctrlHum(0), _ctrlMeas(0), _config(0),
+    _coalesceWindow(0), _rawTime(0), _rawValid(false), _conversionStart(0), _learnedTime(0),
+    _converting(false)
 {
+    // Last burst read: skipped channels as in the data registers
+    _raw.adc_T = 0x80000;
+    _raw.adc_P = 0x80000;
+    _raw.adc_H = 0x8000;
 
+    bmx280PressureCacheReset(&_pressCache);
+    resetMetrics();
 }
 
 /*!
@@ -96,30 +107,63 @@ uint8_t ErriezBMX280::getChipID()
     return _chipID;
 }
 
+/*!
+ * \brief Get device address
+ * \return
+ *      I2C address, or the device address of the bus interface
+ */
+uint8_t ErriezBMX280::getAddress()
+{
+    return _i2cAddr;
+}
+
+/*!
+ * \brief Get bus interface
+ * \return
+ *      Bus interface, NULL = Wire
+ */
+ErriezBMX280Bus *ErriezBMX280::getBus()
+{
+    return _bus;
+}
+
+/*!
+ * \brief Get compensation coefficients
+ * \details
+ *      For compensation of raw samples of this sensor stored elsewhere, such as in a
+ *      sample log.
+ * \return
+ *      Coefficients as read with begin()
+ */
+const BMX280_Calib_t *ErriezBMX280::getCalib()
+{
+    return &_calib;
+}
+
 /*!
  * \brief Read temperature
  * \return
- *      Temperature (float)
+ *      Temperature (float), NAN when the coalesced burst read failed
  */
 float ErriezBMX280::readTemperature()
 {
-    int32_t var1, var2, adc_T;
+    int32_t adc_T;
     float temperature;
 
-    // Read temperature registers
-    adc_T = read24(BMX280_REG_TEMP);
-    adc_T >>= 4;
+    if (_coalesceWindow) {
+        // Served from the burst read shared by all channels within the window
+        if (!coalesce()) {
+            return NAN;
+        }
+        adc_T = _raw.adc_T;
+    } else {
+        // Read temperature registers
+        adc_T = read24(BMX280_REG_TEMP);
+        adc_T >>= 4;
+    }
 
     // See datasheet 4.2.3 Compensation formulas
-    var1 = ((((adc_T >> 3) - ((int32_t)_dig_T1 << 1))) * ((int32_t)_dig_T2)) >> 11;
-
-    var2 = (((((adc_T >> 4) - ((int32_t)_dig_T1)) *
-            ((adc_T >> 4) - ((int32_t)_dig_T1))) >> 12) *
-            ((int32_t)_dig_T3)) >> 14;
-
-    _t_fine = var1 + var2;
-
-    temperature = ((_t_fine * 5) + 128) >> 8;
+    temperature = bmx280CompensateTFast(&_calib, adc_T, &_t_fine);
 
     return temperature / 100.0;
 }
@@ -127,41 +171,29 @@ float ErriezBMX280::readTemperature()
 /*!
  * \brief Read pressure
  * \return
- *      Pressure (float)
+ *      Pressure (float), NAN when the coalesced burst read failed
  */
 float ErriezBMX280::readPressure()
 {
-    int64_t var1;
-    int64_t var2;
-    int64_t p;
     int32_t adc_P;
 
     // Read temperature for t_fine
     readTemperature();
 
-    // Read pressure registers
-    adc_P = read24(BMX280_REG_PRESS);
-    adc_P >>= 4;
-
-    // See datasheet 4.2.3 Compensation formulas
-    var1 = ((int64_t)_t_fine) - 128000;
-    var2 = var1 * var1 * (int64_t)_dig_P6;
-    var2 = var2 + ((var1 * (int64_t)_dig_P5) << 17);
-    var2 = var2 + (((int64_t)_dig_P4) << 35);
-    var1 = ((var1 * var1 * (int64_t)_dig_P3) >> 8) + ((var1 * (int64_t)_dig_P2) << 12);
-    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)_dig_P1) >> 33;
-
-    if (var1 == 0) {
-        return 0; // avoid exception caused by division by zero
+    if (_coalesceWindow) {
+        // Never mix t_fine with a channel of an older burst read
+        if (!_rawValid) {
+            return NAN;
+        }
+        adc_P = _raw.adc_P;
+    } else {
+        // Read pressure registers
+        adc_P = read24(BMX280_REG_PRESS);
+        adc_P >>= 4;
     }
-    p = 1048576 - adc_P;
-    p = (((p << 31) - var2) * 3125) / var1;
-    var1 = (((int64_t)_dig_P9) * (p >> 13) * (p >> 13)) >> 25;
-    var2 = (((int64_t)_dig_P8) * p) >> 19;
 
-    p = ((p + var1 + var2) >> 8) + (((int64_t)_dig_P7) << 4);
-
-    return (float)p / 256;
+    // See datasheet 4.2.3 Compensation formulas
+    return (float)bmx280CompensatePCached(&_calib, &_pressCache, adc_P, _t_fine) / 256;
 }
 
 /*!
@@ -182,44 +214,215 @@ float ErriezBMX280::readAltitude(float seaLevel)
 /*!
  * \brief Read humidity (BME280 only)
  * \return
- *      Humidity (float)
+ *      Humidity (float), 0 when humidity sampling is disabled, NAN when the
+ *      coalesced burst read failed
  */
 float ErriezBMX280::readHumidity()
 {
-    int32_t v_x1_u32r;
     int32_t adc_H;
     float humidity;
 
-    if (_chipID != CHIP_ID_BME280) {
+    // Same as a sample without humidity, with or without coalescing
+    if ((_chipID != CHIP_ID_BME280) || ((_ctrlHum & 0x07) == BMX280_SAMPLING_NONE)) {
         return 0;
     }
 
     // Read temperature for t_fine
     readTemperature();
 
-    // Read humidity registers
-    adc_H = read16(BME280_REG_HUM);
+    if (_coalesceWindow) {
+        if (!_rawValid) {
+            return NAN;
+        }
+        adc_H = _raw.adc_H;
+    } else {
+        // Read humidity registers
+        adc_H = read16(BME280_REG_HUM);
+    }
 
     // See datasheet 4.2.3 Compensation formulas
-    v_x1_u32r = (_t_fine - ((int32_t)76800));
+    humidity = bmx280CompensateHFast(&_calib, adc_H, _t_fine);
 
-    v_x1_u32r = ((((adc_H << 14) - (((int32_t)_dig_H4) << 20) - (((int32_t)_dig_H5) * v_x1_u32r)) +
-                  ((int32_t)16384)) >> 15) *
-                (((((((v_x1_u32r *
-                       ((int32_t)_dig_H6)) >> 10) *
-                     (((v_x1_u32r *
-                        ((int32_t)_dig_H3)) >> 11) + ((int32_t)32768))) >> 10) + ((int32_t)2097152)) *
-                  ((int32_t)_dig_H2) + 8192) >> 14);
+    return humidity / 1024.0;
+}
 
-    v_x1_u32r = (v_x1_u32r - (((((v_x1_u32r >> 15) * (v_x1_u32r >> 15)) >> 7) *
-                               ((int32_t)_dig_H1)) >> 4));
+/*!
+ * \brief Burst read all data registers
+ * \details
+ *      One bus transaction reads pressure, temperature and humidity (BME280).
+ *      Channels are compensated on first access of the returned sample.
+ * \return
+ *      Sample, invalid when the bus read failed
+ */
+ErriezBMX280Sample ErriezBMX280::readAll()
+{
+    uint8_t buf[BME280_DATA_LEN];
 
-    v_x1_u32r = (v_x1_u32r < 0) ? 0 : v_x1_u32r;
-    v_x1_u32r = (v_x1_u32r > 419430400) ? 419430400 : v_x1_u32r;
+    _rawValid = false;
 
-    humidity = (v_x1_u32r >> 12);
+    // See datasheet 4 Data readout: burst read from 0xF7 to 0xFC (0xFE BME280)
+    if (!readBuffer(BMX280_REG_PRESS, buf, getDataLength())) {
+        return ErriezBMX280Sample();
+    }
 
-    return humidity / 1024.0;
+    return decode(buf);
+}
+
+/*!
+ * \brief Decode data registers read by the application
+ * \details
+ *      For data registers read outside the driver, for example by a batched read of
+ *      several sensors on one bus. The result is also used by request coalescing.
+ *      The sample holds no humidity when humidity sampling is disabled.
+ * \param data
+ *      getDataLength() bytes from register BMX280_REG_PRESS
+ * \return
+ *      Sample, compensated on access
+ */
+ErriezBMX280Sample ErriezBMX280::decode(const uint8_t *data)
+{
+    // Skipped humidity channel reads 0x8000
+    bool humidity = (_chipID == CHIP_ID_BME280) &&
+                    ((_ctrlHum & 0x07) != BMX280_SAMPLING_NONE);
+
+    _raw.adc_P = ((uint32_t)data[0] << 12) | ((uint32_t)data[1] << 4) | (data[2] >> 4);
+    _raw.adc_T = ((uint32_t)data[3] << 12) | ((uint32_t)data[4] << 4) | (data[5] >> 4);
+    _raw.adc_H = humidity ? (((uint16_t)data[6] << 8) | data[7]) : 0;
+    _rawTime = micros();
+    _rawValid = true;
+    _metrics.samples++;
+
+    return ErriezBMX280Sample(&_calib, _raw, humidity, &_pressCache);
+}
+
+/*!
+ * \brief Get length of the data registers
+ * \return
+ *      BMP280_DATA_LEN or BME280_DATA_LEN bytes
+ */
+uint8_t ErriezBMX280::getDataLength()
+{
+    return (_chipID == CHIP_ID_BME280) ? BME280_DATA_LEN : BMP280_DATA_LEN;
+}
+
+/*!
+ * \brief Set request coalescing window
+ * \details
+ *      readTemperature(), readPressure(), readHumidity() and readAltitude() calls
+ *      within the window are served from one burst read instead of reading the
+ *      channel registers for each call.
+ * \param windowMs
+ *      Window in ms, 0 = disabled
+ */
+void ErriezBMX280::setCoalescingWindow(uint16_t windowMs)
+{
+    _coalesceWindow = windowMs * 1000UL;
+    _rawValid = false;
+}
+
+/*!
+ * \brief Flush coalesced burst read
+ * \details
+ *      The next read call within the coalescing window reads the sensor again.
+ */
+void ErriezBMX280::flush()
+{
+    _rawValid = false;
+}
+
+/*!
+ * \brief Get bus instrumentation counters
+ * \return
+ *      Counters since construction or resetMetrics()
+ */
+const BMX280_Metrics_t &ErriezBMX280::getMetrics()
+{
+    return _metrics;
+}
+
+/*!
+ * \brief Clear bus instrumentation counters
+ */
+void ErriezBMX280::resetMetrics()
+{
+    memset(&_metrics, 0, sizeof(_metrics));
+}
+
+/*!
+ * \brief Print metric name with sensor label
+ * \param out
+ *      Output
+ * \param name
+ *      Metric name
+ * \param sensor
+ *      Sensor label
+ */
+static void printMetricName(Print &out, const __FlashStringHelper *name, const char *sensor)
+{
+    out.print(F("bmx280_"));
+    out.print(name);
+    out.print(F("{sensor=\""));
+    out.print(sensor);
+    out.print(F("\"} "));
+}
+
+/*!
+ * \brief Print bus instrumentation counters and last values in text exposition format
+ * \details
+ *      One "name{sensor=\"label\"} value" line per metric, readable by textfile metrics
+ *      collectors. Sample rates follow from the samples_total counter. Print all
+ *      sensors to a temporary file and rename it to replace the metrics file
+ *      atomically. Last values are printed when the last burst read succeeded.
+ * \param out
+ *      Output, for example Serial or a file
+ * \param sensor
+ *      Sensor label
+ */
+void ErriezBMX280::printMetrics(Print &out, const char *sensor)
+{
+    printMetricName(out, F("transactions_total"), sensor);
+    out.println(_metrics.transactions);
+    printMetricName(out, F("bytes_total"), sensor);
+    out.println(_metrics.bytes);
+    printMetricName(out, F("errors_total"), sensor);
+    out.println(_metrics.errors);
+    printMetricName(out, F("samples_total"), sensor);
+    out.println(_metrics.samples);
+    printMetricName(out, F("latency_p50_us"), sensor);
+    out.println(_metrics.latencyP50);
+    printMetricName(out, F("latency_p99_us"), sensor);
+    out.println(_metrics.latencyP99);
+    printMetricName(out, F("latency_max_us"), sensor);
+    out.println(_metrics.latencyMax);
+
+    if (_rawValid) {
+        ErriezBMX280Sample sample(&_calib, _raw, (_chipID == CHIP_ID_BME280), &_pressCache);
+
+        printMetricName(out, F("temperature_celsius"), sensor);
+        out.println(sample.getTemperature());
+        printMetricName(out, F("pressure_pascal"), sensor);
+        out.println(sample.getPressure());
+        if (sample.hasHumidity()) {
+            printMetricName(out, F("humidity_percent"), sensor);
+            out.println(sample.getHumidity());
+        }
+    }
+}
+
+/*!
+ * \brief Burst read data registers when the last burst read is outside the coalescing window
+ * \retval true
+ *      Raw values available
+ * \retval false
+ *      Error: Bus read failed
+ */
+bool ErriezBMX280::coalesce()
+{
+    if (_rawValid && ((micros() - _rawTime) < _coalesceWindow)) {
+        return true;
+    }
+
+    return readAll().isValid();
 }
 
 /*!
@@ -227,27 +430,29 @@ float ErriezBMX280::readHumidity()
  */
 void ErriezBMX280::readCoefficients(void)
 {
-    _dig_T1 = read16_LE(BMX280_REG_DIG_T1);
-    _dig_T2 = readS16_LE(BMX280_REG_DIG_T2);
-    _dig_T3 = readS16_LE(BMX280_REG_DIG_T3);
-
-    _dig_P1 = read16_LE(BMX280_REG_DIG_P1);
-    _dig_P2 = readS16_LE(BMX280_REG_DIG_P2);
-    _dig_P3 = readS16_LE(BMX280_REG_DIG_P3);
-    _dig_P4 = readS16_LE(BMX280_REG_DIG_P4);
-    _dig_P5 = readS16_LE(BMX280_REG_DIG_P5);
-    _dig_P6 = readS16_LE(BMX280_REG_DIG_P6);
-    _dig_P7 = readS16_LE(BMX280_REG_DIG_P7);
-    _dig_P8 = readS16_LE(BMX280_REG_DIG_P8);
-    _dig_P9 = readS16_LE(BMX280_REG_DIG_P9);
+    bmx280PressureCacheReset(&_pressCache);
+
+    _calib.dig_T1 = read16_LE(BMX280_REG_DIG_T1);
+    _calib.dig_T2 = readS16_LE(BMX280_REG_DIG_T2);
+    _calib.dig_T3 = readS16_LE(BMX280_REG_DIG_T3);
+
+    _calib.dig_P1 = read16_LE(BMX280_REG_DIG_P1);
+    _calib.dig_P2 = readS16_LE(BMX280_REG_DIG_P2);
+    _calib.dig_P3 = readS16_LE(BMX280_REG_DIG_P3);
+    _calib.dig_P4 = readS16_LE(BMX280_REG_DIG_P4);
+    _calib.dig_P5 = readS16_LE(BMX280_REG_DIG_P5);
+    _calib.dig_P6 = readS16_LE(BMX280_REG_DIG_P6);
+    _calib.dig_P7 = readS16_LE(BMX280_REG_DIG_P7);
+    _calib.dig_P8 = readS16_LE(BMX280_REG_DIG_P8);
+    _calib.dig_P9 = readS16_LE(BMX280_REG_DIG_P9);
 
     if (_chipID == CHIP_ID_BME280) {
-        _dig_H1 = read8(BME280_REG_DIG_H1);
-        _dig_H2 = readS16_LE(BME280_REG_DIG_H2);
-        _dig_H3 = read8(BME280_REG_DIG_H3);
-        _dig_H4 = ((int8_t) read8(BME280_REG_DIG_H4) << 4) | (read8(BME280_REG_DIG_H4 + 1) & 0xF);
-        _dig_H5 = ((int8_t) read8(BME280_REG_DIG_H5 + 1) << 4) | (read8(BME280_REG_DIG_H5) >> 4);
-        _dig_H6 = (int8_t) read8(BME280_REG_DIG_H6);
+        _calib.dig_H1 = read8(BME280_REG_DIG_H1);
+        _calib.dig_H2 = readS16_LE(BME280_REG_DIG_H2);
+        _calib.dig_H3 = read8(BME280_REG_DIG_H3);
+        _calib.dig_H4 = ((int8_t) read8(BME280_REG_DIG_H4) << 4) | (read8(BME280_REG_DIG_H4 + 1) & 0xF);
+        _calib.dig_H5 = ((int8_t) read8(BME280_REG_DIG_H5 + 1) << 4) | (read8(BME280_REG_DIG_H5) >> 4);
+        _calib.dig_H6 = (int8_t) read8(BME280_REG_DIG_H6);
     }
 }
 
@@ -273,17 +478,259 @@ void ErriezBMX280::setSampling(BMX280_Mode_e mode,
                                BMX280_Filter_e filter,
                                BMX280_Standby_e standbyDuration)
 {
+    _ctrlHum = humSampling;
+    _config = (standbyDuration << 5) | (filter << 2);
+    _ctrlMeas = (tempSampling << 5) | (pressSampling << 2) | mode;
+    _learnedTime = 0;
+    // The coalesced burst read was decoded with the previous channels
+    _rawValid = false;
+
     // Set in sleep mode to provide write access to the “config” register
     write8(BMX280_REG_CTRL_MEAS, BMX280_MODE_SLEEP);
 
     if (_chipID == CHIP_ID_BME280) {
         // See datasheet 5.4.3 Register 0xF2 “ctrl_hum”
-        write8(BME280_REG_CTRL_HUM, humSampling);
+        write8(BME280_REG_CTRL_HUM, _ctrlHum);
     }
     // See datasheet 5.4.6 Register 0xF5 “config”
-    write8(BMX280_REG_CONFIG, (standbyDuration << 5) | (filter << 2));
+    write8(BMX280_REG_CONFIG, _config);
     // See datasheet 5.4.5 Register 0xF4 “ctrl_meas”
-    write8(BMX280_REG_CTRL_MEAS, (tempSampling << 5) | (pressSampling << 2) | mode);
+    write8(BMX280_REG_CTRL_MEAS, _ctrlMeas);
+}
+
+/*!
+ * \brief Get mode as set with setSampling()
+ * \return
+ *      See BMX280_Mode_e
+ */
+BMX280_Mode_e ErriezBMX280::getMode()
+{
+    return (BMX280_Mode_e)(_ctrlMeas & 0x03);
+}
+
+/*!
+ * \brief Get maximum conversion time of the sampling set with setSampling()
+ * \details
+ *      See datasheet 9.1 Measurement time
+ * \return
+ *      Conversion time in us
+ */
+uint32_t ErriezBMX280::getConversionTime()
+{
+    // Number of samples per BMX280_Sampling_e value
+    static const uint8_t samples[8] = { 0, 1, 2, 4, 8, 16, 16, 16 };
+    uint8_t osrsT = samples[(_ctrlMeas >> 5) & 0x07];
+    uint8_t osrsP = samples[(_ctrlMeas >> 2) & 0x07];
+    uint8_t osrsH = (_chipID == CHIP_ID_BME280) ? samples[_ctrlHum & 0x07] : 0;
+    uint32_t t;
+
+    t = 1250 + (2300UL * osrsT);
+    if (osrsP) {
+        t += (2300UL * osrsP) + 575;
+    }
+    if (osrsH) {
+        t += (2300UL * osrsH) + 575;
+    }
+
+    return t;
+}
+
+/*!
+ * \brief Get time between two samples
+ * \details
+ *      Normal mode: conversion time + standby time, see datasheet 3.3.4 Normal mode.
+ *      Forced mode: conversion time.
+ * \return
+ *      Sample period in us
+ */
+uint32_t ErriezBMX280::getSamplePeriod()
+{
+    // Standby time per BMX280_Standby_e value, 0b110 and 0b111 are 2s and 4s on BMP280
+    static const uint32_t standby[8] = { 500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000 };
+    uint8_t t_sb = (_config >> 5) & 0x07;
+
+    if (getMode() != BMX280_MODE_NORMAL) {
+        return getConversionTime();
+    }
+    if ((_chipID == CHIP_ID_BMP280) && (t_sb >= 0b110)) {
+        return getConversionTime() + ((t_sb == 0b110) ? 2000000UL : 4000000UL);
+    }
+
+    return getConversionTime() + standby[t_sb];
+}
+
+/*!
+ * \brief Start one conversion in forced mode with the sampling set with setSampling()
+ */
+void ErriezBMX280::startConversion()
+{
+    // See datasheet 3.3.3 Forced mode
+    write8(BMX280_REG_CTRL_MEAS, (_ctrlMeas & ~0x03) | BMX280_MODE_FORCED);
+    _conversionStart = micros();
+    _converting = true;
+}
+
+/*!
+ * \brief Get conversion status
+ * \retval true
+ *      Conversion is running
+ * \retval false
+ *      Results transferred to the data registers
+ */
+bool ErriezBMX280::isMeasuring()
+{
+    return (read8(BMX280_REG_STATUS) & (1 << STATUS_MEASURING)) ? true : false;
+}
+
+/*!
+ * \brief Wait for a conversion started with startConversion()
+ * \details
+ *      Waits the learned conversion time after the start of the conversion and polls
+ *      the measuring bit once. The learned time is a running 99% quantile of the
+ *      actual conversion time of this chip: a first poll finding the conversion done
+ *      decreases it by one step, a first poll finding it still running increases it
+ *      by 99 steps. No poll is needed when called after the maximum conversion time.
+ *      Returns immediately when no conversion was started.
+ */
+void ErriezBMX280::waitConversion()
+{
+    uint32_t t = getConversionTime();
+    uint32_t step = (t >> 11) + 1;
+    bool learn;
+
+    if (!_converting) {
+        return;
+    }
+
+    if ((_learnedTime == 0) || (_learnedTime > t)) {
+        _learnedTime = t;
+    }
+
+    // Only a poll at the learned time tells whether the learned time is too short
+    learn = (micros() - _conversionStart) < _learnedTime;
+    while ((micros() - _conversionStart) < _learnedTime) {
+        yield();
+    }
+
+    if (learn || ((micros() - _conversionStart) < t)) {
+        if (!isMeasuring()) {
+            if (learn && (_learnedTime > (t / 2))) {
+                _learnedTime -= step;
+            }
+        } else {
+            if (learn) {
+                _learnedTime += 99 * step;
+            }
+            // Poll status until done, give up after a second conversion time
+            do {
+                uint32_t poll = micros();
+
+                while ((micros() - poll) < (99 * step)) {
+                    yield();
+                }
+            } while (isMeasuring() && ((micros() - _conversionStart) < (2 * t)));
+        }
+    }
+
+    _converting = false;
+}
+
+/*!
+ * \brief Get learned conversion time
+ * \details
+ *      Diagnostics: conversion time waited by waitConversion(), learned from the
+ *      actual conversion times of this chip. Reset by setSampling().
+ * \return
+ *      Conversion time in us
+ */
+uint32_t ErriezBMX280::getLearnedConversionTime()
+{
+    if (_learnedTime == 0) {
+        return getConversionTime();
+    }
+
+    return _learnedTime;
+}
+
+/*!
+ * \brief Pipelined forced mode read
+ * \details
+ *      Waits for the running conversion, burst reads it and immediately starts the
+ *      next conversion. Processing of the returned sample overlaps with the next
+ *      conversion, so the next call only waits for the remaining conversion time.
+ *      The first call starts a conversion and waits for it.
+ * \return
+ *      Sample, invalid when the bus read failed
+ */
+ErriezBMX280Sample ErriezBMX280::readPipelined()
+{
+    ErriezBMX280Sample sample;
+
+    if (!_converting) {
+        startConversion();
+    }
+    waitConversion();
+
+    sample = readAll();
+
+    // Start conversion N+1 before sample N is processed
+    startConversion();
+
+    return sample;
+}
+
+/*!
+ * \brief Measure once in forced mode with minimum awake time
+ * \details
+ *      For nodes which wake, sample and sleep. Starts a forced conversion with one
+ *      ctrl_meas write of the sampling set with setSampling(), waits the learned
+ *      conversion time and burst reads only the data registers of the enabled
+ *      channels. ctrl_hum and config keep their values while the sensor sleeps, so
+ *      setSampling() is only needed once after begin(). The sensor returns to sleep
+ *      mode after the conversion.
+ * \return
+ *      Sample, invalid when the bus read failed
+ */
+ErriezBMX280Sample ErriezBMX280::measureOnce()
+{
+    // Skipped channels as in the data registers: 0x80000 and 0x8000
+    uint8_t buf[BME280_DATA_LEN] = { 0x80, 0x00, 0x00, 0x80, 0x00, 0x00, 0x80, 0x00 };
+    uint8_t first = 0;
+    uint8_t last = getDataLength();
+
+    startConversion();
+    waitConversion();
+
+    // Temperature is always read, it is required to compensate the other channels
+    if (((_ctrlMeas >> 2) & 0x07) == BMX280_SAMPLING_NONE) {
+        first = 3;
+    }
+    if ((_ctrlHum & 0x07) == BMX280_SAMPLING_NONE) {
+        last = BMP280_DATA_LEN;
+    }
+
+    _rawValid = false;
+    if (!readBuffer(BMX280_REG_PRESS + first, &buf[first], last - first)) {
+        return ErriezBMX280Sample();
+    }
+
+    return decode(buf);
+}
+
+/*!
+ * \brief Create a continuous sample stream
+ * \details
+ *      for (ErriezBMX280Sample &sample : bmx280.stream(100)) { ... }
+ * \param intervalMs
+ *      Time between samples in ms, 0 = sample period of the sensor configuration
+ * \param count
+ *      Number of samples, 0 = endless
+ * \return
+ *      Input range of samples
+ */
+ErriezBMX280Stream ErriezBMX280::stream(uint16_t intervalMs, uint32_t count)
+{
+    return ErriezBMX280Stream(this, intervalMs, count);
 }
 
 /*!
@@ -295,13 +742,13 @@ void ErriezBMX280::setSampling(BMX280_Mode_e mode,
  */
 uint8_t ErriezBMX280::read8(uint8_t reg)
 {
-    Wire.beginTransmission(_i2cAddr);
-    Wire.write(reg);
-    if (Wire.endTransmission() != 0) {
+    uint8_t value;
+
+    if (!readBuffer(reg, &value, 1)) {
         return 0;
     }
-    Wire.requestFrom(_i2cAddr, (byte)1);
-    return Wire.read();
+
+    return value;
 }
 
 /*!
@@ -313,10 +760,19 @@ uint8_t ErriezBMX280::read8(uint8_t reg)
  */
 void ErriezBMX280::write8(uint8_t reg, uint8_t value)
 {
-    Wire.beginTransmission(_i2cAddr);
-    Wire.write(reg);
-    Wire.write(value);
-    Wire.endTransmission();
+    uint32_t start = micros();
+    bool success;
+
+    if (_bus) {
+        success = _bus->write(_i2cAddr, reg, value);
+    } else {
+        Wire.beginTransmission(_i2cAddr);
+        Wire.write(reg);
+        Wire.write(value);
+        success = (Wire.endTransmission() == 0);
+    }
+
+    countTransaction(start, 1, success);
 }
 
 /*!
@@ -356,13 +812,13 @@ int16_t ErriezBMX280::readS16_LE(uint8_t reg)
  */
 uint16_t ErriezBMX280::read16(uint8_t reg)
 {
-    Wire.beginTransmission(_i2cAddr);
-    Wire.write(reg);
-    if (Wire.endTransmission() != 0) {
+    uint8_t buf[2];
+
+    if (!readBuffer(reg, buf, sizeof(buf))) {
         return 0;
     }
-    Wire.requestFrom(_i2cAddr, (byte)2);
-    return (Wire.read() << 8) | Wire.read();
+
+    return ((uint16_t)buf[0] << 8) | buf[1];
 }
 
 /*!
@@ -374,18 +830,106 @@ uint16_t ErriezBMX280::read16(uint8_t reg)
  */
 uint32_t ErriezBMX280::read24(uint8_t reg)
 {
-    uint32_t value;
+    uint8_t buf[3];
 
-    Wire.beginTransmission(_i2cAddr);
-    Wire.write(reg);
-    Wire.endTransmission();
-    Wire.requestFrom(_i2cAddr, (byte)3);
+    if (!readBuffer(reg, buf, sizeof(buf))) {
+        return 0;
+    }
 
-    value = Wire.read();
-    value <<= 8;
-    value |= Wire.read();
-    value <<= 8;
-    value |= Wire.read();
+    return ((uint32_t)buf[0] << 16) | ((uint16_t)buf[1] << 8) | buf[2];
+}
 
-    return value;
-}
\ No newline at end of file
+/*!
+ * \brief Burst read from consecutive registers
+ * \param reg
+ *      First register address
+ * \param buffer
+ *      Buffer to store register values
+ * \param len
+ *      Number of registers
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Bus transfer failed
+ */
+bool ErriezBMX280::readBuffer(uint8_t reg, uint8_t *buffer, uint8_t len)
+{
+    uint32_t start = micros();
+    bool success = true;
+
+    if (_bus) {
+        success = _bus->read(_i2cAddr, reg, buffer, len);
+    } else {
+        Wire.beginTransmission(_i2cAddr);
+        Wire.write(reg);
+        if (Wire.endTransmission() != 0) {
+            success = false;
+        } else if (Wire.requestFrom(_i2cAddr, len) != len) {
+            success = false;
+        } else {
+            for (uint8_t i = 0; i < len; i++) {
+                buffer[i] = Wire.read();
+            }
+        }
+    }
+
+    countTransaction(start, len, success);
+
+    return success;
+}
+
+/*!
+ * \brief Count a bus transaction and update the latency estimates
+ * \details
+ *      The quantiles are estimated without storing transaction times: an estimate
+ *      steps towards each transaction time, the 99th percentile steps up 99 times
+ *      further than down. Call for transactions done outside the driver, for example
+ *      a batched read of several sensors followed by decode().
+ * \param start
+ *      Start of the transaction in us
+ * \param bytes
+ *      Register bytes transferred
+ * \param success
+ *      Transaction succeeded
+ */
+void ErriezBMX280::countTransaction(uint32_t start, uint8_t bytes, bool success)
+{
+    uint32_t duration = micros() - start;
+    uint16_t latency = (duration > 0xFFFF) ? 0xFFFF : duration;
+    uint32_t step;
+
+    _metrics.transactions++;
+    _metrics.bytes += bytes;
+    if (!success) {
+        _metrics.errors++;
+    }
+
+    if (latency > _metrics.latencyMax) {
+        _metrics.latencyMax = latency;
+    }
+
+    // Start at the first transaction time
+    if (_metrics.transactions == 1) {
+        _metrics.latencyP50 = latency;
+        _metrics.latencyP99 = latency;
+        return;
+    }
+
+    step = (_metrics.latencyP50 >> 6) + 1;
+    if (latency > _metrics.latencyP50) {
+        _metrics.latencyP50 += ((uint32_t)(latency - _metrics.latencyP50) < step) ?
+                               (latency - _metrics.latencyP50) : step;
+    } else if (latency < _metrics.latencyP50) {
+        _metrics.latencyP50 -= ((uint32_t)(_metrics.latencyP50 - latency) < step) ?
+                               (_metrics.latencyP50 - latency) : step;
+    }
+
+    step = (_metrics.latencyP99 >> 6) + 1;
+    if (latency > _metrics.latencyP99) {
+        _metrics.latencyP99 += ((uint32_t)(latency - _metrics.latencyP99) < (99 * step)) ?
+                               (latency - _metrics.latencyP99) : (99 * step);
+    } else if (latency < _metrics.latencyP99) {
+        _metrics.latencyP99 -= ((uint32_t)(_metrics.latencyP99 - latency) < step) ?
+                               (_metrics.latencyP99 - latency) : step;
+    }
+}
@@ -39,6 +39,11 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+#include "ErriezBMX280Bus.h"
+#include "ErriezBMX280Compensate.h"
+#include "ErriezBMX280Sample.h"
+#include "ErriezBMX280Stream.h"
+
 // I2C address
 #define BMX280_I2C_ADDR             0x76    //!< I2C address
 #define BMX280_I2C_ADDR_ALT         0x77    //!< I2C alternative address
@@ -76,11 +81,16 @@
 #define BMX280_REG_TEMP             0xFA    //!< Temperature data register
 #define BME280_REG_HUM              0xFD    //!< Humidity data register
 
+// Burst read lengths data registers
+#define BMP280_DATA_LEN             6       //!< BMP280: Pressure and temperature
+#define BME280_DATA_LEN             8       //!< BME280: Pressure, temperature and humidity
+
 // Bit defines
 #define CHIP_ID_BMP280              0x58    //!< BMP280 chip ID
 #define CHIP_ID_BME280              0x60    //!< BME280 chip ID
 #define RESET_KEY                   0xB6    //!< Reset value for reset register
 #define STATUS_IM_UPDATE            0       //!< im_update bit in status register
+#define STATUS_MEASURING            3       //!< measuring bit in status register
 
 /*!
  * \brief Sleep mode bits ctrl_meas register
@@ -128,6 +138,19 @@ typedef enum {
     BMX280_STANDBY_MS_1000 = 0b101          //!< 1s standby
 } BMX280_Standby_e;
 
+/*!
+ * \brief Bus instrumentation counters
+ */
+typedef struct {
+    uint32_t transactions;      //!< Bus transactions
+    uint32_t bytes;             //!< Register bytes read and written
+    uint32_t errors;            //!< Failed bus transactions
+    uint32_t samples;           //!< Decoded data register reads
+    uint16_t latencyP50;        //!< Estimated median transaction time in us
+    uint16_t latencyP99;        //!< Estimated 99th percentile transaction time in us
+    uint16_t latencyMax;        //!< Longest transaction time in us
+} BMX280_Metrics_t;
+
 /*!
  * \brief BMX280 class
  */
@@ -135,11 +158,14 @@ class ErriezBMX280
 {
 public:
     // Constructor
-    ErriezBMX280(uint8_t i2cAddr);
+    ErriezBMX280(uint8_t i2cAddr = BMX280_I2C_ADDR, ErriezBMX280Bus *bus = NULL);
 
     // Initialization
     bool begin();
     uint8_t getChipID();
+    uint8_t getAddress();
+    ErriezBMX280Bus *getBus();
+    const BMX280_Calib_t *getCalib();
 
     // BMP280/BME280
     float readTemperature();
@@ -149,6 +175,21 @@ public:
     // BME280 only
     float readHumidity();
 
+    // Burst read all channels, compensated on access
+    ErriezBMX280Sample readAll();
+    ErriezBMX280Sample decode(const uint8_t *data);
+    uint8_t getDataLength();
+
+    // Serve read calls within a window from one burst read
+    void setCoalescingWindow(uint16_t windowMs);
+    void flush();
+
+    // Bus instrumentation
+    const BMX280_Metrics_t &getMetrics();
+    void resetMetrics();
+    void printMetrics(Print &out, const char *sensor = "0");
+    void countTransaction(uint32_t start, uint8_t bytes, bool success);
+
     // Configuration
     void setSampling(BMX280_Mode_e mode = BMX280_MODE_NORMAL,
                      BMX280_Sampling_e tempSampling = BMX280_SAMPLING_X16,
@@ -156,6 +197,20 @@ public:
                      BMX280_Sampling_e humSampling = BMX280_SAMPLING_X16,
                      BMX280_Filter_e filter = BMX280_FILTER_OFF,
                      BMX280_Standby_e standbyDuration = BMX280_STANDBY_MS_0_5);
+    BMX280_Mode_e getMode();
+    uint32_t getConversionTime();
+    uint32_t getSamplePeriod();
+
+    // Conversion control
+    void startConversion();
+    bool isMeasuring();
+    void waitConversion();
+    ErriezBMX280Sample readPipelined();
+    ErriezBMX280Sample measureOnce();
+    uint32_t getLearnedConversionTime();
+
+    // Continuous sample stream
+    ErriezBMX280Stream stream(uint16_t intervalMs = 0, uint32_t count = 0);
 
     // Register access
     uint8_t read8(uint8_t reg);
@@ -163,36 +218,37 @@ public:
     uint16_t read16_LE(uint8_t reg); // little endian unsigned
     int16_t readS16_LE(uint8_t reg); // little endian signed
     uint32_t read24(uint8_t reg);
+    bool readBuffer(uint8_t reg, uint8_t *buffer, uint8_t len);
     void write8(uint8_t reg, uint8_t value);
 
 private:
     uint8_t _i2cAddr;   //!< I2C address
+    ErriezBMX280Bus *_bus; //!< Bus interface, NULL = Wire
     uint8_t _chipID;    //!< Chip iD
     int32_t _t_fine;    //!< Temperature variable
 
-    uint16_t _dig_T1;
-    int16_t _dig_T2;
-    int16_t _dig_T3;
-
-    uint16_t _dig_P1;
-    int16_t _dig_P2;
-    int16_t _dig_P3;
-    int16_t _dig_P4;
-    int16_t _dig_P5;
-    int16_t _dig_P6;
-    int16_t _dig_P7;
-    int16_t _dig_P8;
-    int16_t _dig_P9;
-
-    uint8_t _dig_H1;
-    int16_t _dig_H2;
-    uint8_t _dig_H3;
-    int16_t _dig_H4;
-    int16_t _dig_H5;
-    int8_t _dig_H6;
+    uint8_t _ctrlHum;   //!< Shadow register ctrl_hum
+    uint8_t _ctrlMeas;  //!< Shadow register ctrl_meas
+    uint8_t _config;    //!< Shadow register config
+
+    uint32_t _coalesceWindow;   //!< Coalescing window in us, 0 = disabled
+    uint32_t _rawTime;          //!< Time of last burst read in us
+    BMX280_Raw_t _raw;          //!< Last burst read
+    bool _rawValid;             //!< Last burst read succeeded
+
+    uint32_t _conversionStart;  //!< Start of forced mode conversion in us
+    uint32_t _learnedTime;      //!< Learned conversion time in us, 0 = not learned
+    bool _converting;           //!< Forced mode conversion started
+
+    BMX280_Calib_t _calib;  //!< Compensation coefficients
+    BMX280_PressureCache_t _pressCache; //!< Pressure terms of last t_fine
+
+    BMX280_Metrics_t _metrics;  //!< Bus instrumentation counters
 
     // Read coefficient registers
     void readCoefficients(void);
+
+    bool coalesce();
 };
 
 #endif // ERRIEZ_BMX280_H_
\ No newline at end of file
@@ -0,0 +1,866 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Archive.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Columnar archive of compensated samples with zone maps for range queries
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280Archive.h"
+#include "ErriezBMX280Log.h"
+
+/*!
+ * \brief Buffered sequential write to storage with CRC
+ */
+typedef struct {
+    ErriezBMX280Storage *storage;   //!< Storage
+    uint32_t addr;                  //!< Address of buf[0]
+    uint16_t crc;                   //!< CRC of all bytes put
+    uint8_t len;                    //!< Bytes in buf
+    uint8_t buf[16];                //!< Bytes not yet written
+} ArchiveWriter_t;
+
+/*!
+ * \brief Buffered sequential read of one column
+ */
+typedef struct {
+    uint32_t addr;                  //!< Address of the next storage read
+    uint16_t remaining;             //!< Column bytes not yet read from storage
+    uint8_t pos;                    //!< Next byte in buf
+    uint8_t len;                    //!< Bytes in buf
+    uint8_t buf[8];                 //!< Bytes read
+} ArchiveCursor_t;
+
+/*!
+ * \brief Encode the difference of one column to the previous sample
+ * \param sample
+ *      Sample
+ * \param prev
+ *      Previous sample of the chunk, all zero for the first
+ * \param column
+ *      0 = timestamp, 1 = temperature, 2 = pressure, 3 = humidity
+ * \return
+ *      Value to varint encode
+ */
+static uint32_t encodeColumn(const BMX280_ArchiveSample_t *sample,
+                             const BMX280_ArchiveSample_t *prev, uint8_t column)
+{
+    int32_t delta;
+
+    switch (column) {
+        case 0:
+            return sample->timestamp - prev->timestamp;
+        case 1:
+            delta = sample->temperature - prev->temperature;
+            break;
+        case 2:
+            delta = (int32_t)(sample->pressure - prev->pressure);
+            break;
+        default:
+            delta = (int32_t)(sample->humidity - prev->humidity);
+            break;
+    }
+
+    // Zigzag: small negative and positive differences become small values
+    return ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+}
+
+/*!
+ * \brief Decode one column, reverse of encodeColumn()
+ * \param sample
+ *      Sample to update
+ * \param prev
+ *      Previous sample of the chunk, all zero for the first
+ * \param column
+ *      0 = timestamp, 1 = temperature, 2 = pressure, 3 = humidity
+ * \param value
+ *      Varint decoded value
+ */
+static void decodeColumn(BMX280_ArchiveSample_t *sample, const BMX280_ArchiveSample_t *prev,
+                         uint8_t column, uint32_t value)
+{
+    int32_t delta = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+
+    switch (column) {
+        case 0:
+            sample->timestamp = prev->timestamp + value;
+            break;
+        case 1:
+            sample->temperature = prev->temperature + delta;
+            break;
+        case 2:
+            sample->pressure = prev->pressure + (uint32_t)delta;
+            break;
+        default:
+            sample->humidity = prev->humidity + (uint32_t)delta;
+            break;
+    }
+}
+
+/*!
+ * \brief Get varint length
+ * \param value
+ *      Value
+ * \return
+ *      1..5 bytes
+ */
+static uint8_t varintLength(uint32_t value)
+{
+    uint8_t len = 1;
+
+    while (value >= 0x80) {
+        value >>= 7;
+        len++;
+    }
+
+    return len;
+}
+
+/*!
+ * \brief Put a byte, written to storage in blocks
+ * \param w
+ *      Writer
+ * \param value
+ *      Byte
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Write failed
+ */
+static bool writerPut(ArchiveWriter_t *w, uint8_t value)
+{
+    w->buf[w->len++] = value;
+    w->crc = bmx280Crc16(&value, 1, w->crc);
+    if (w->len == sizeof(w->buf)) {
+        if (!w->storage->write(w->addr, w->buf, w->len)) {
+            return false;
+        }
+        w->addr += w->len;
+        w->len = 0;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Write remaining bytes
+ * \param w
+ *      Writer
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Write failed
+ */
+static bool writerFlush(ArchiveWriter_t *w)
+{
+    if (w->len && !w->storage->write(w->addr, w->buf, w->len)) {
+        return false;
+    }
+    w->addr += w->len;
+    w->len = 0;
+
+    return true;
+}
+
+/*!
+ * \brief Read a varint from a column
+ * \param storage
+ *      Storage
+ * \param c
+ *      Column cursor
+ * \param value
+ *      Decoded value
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Read failed or end of column
+ */
+static bool cursorGet(ErriezBMX280Storage *storage, ArchiveCursor_t *c, uint32_t *value)
+{
+    uint8_t shift = 0;
+    uint8_t b;
+
+    *value = 0;
+    do {
+        if (c->pos == c->len) {
+            if (c->remaining == 0) {
+                return false;
+            }
+            c->len = (c->remaining < sizeof(c->buf)) ? c->remaining : sizeof(c->buf);
+            if (!storage->read(c->addr, c->buf, c->len)) {
+                return false;
+            }
+            c->addr += c->len;
+            c->remaining -= c->len;
+            c->pos = 0;
+        }
+        b = c->buf[c->pos++];
+        *value |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while ((b & 0x80) && (shift < 35));
+
+    return true;
+}
+
+/*!
+ * \brief Check if a zone map overlaps a query range
+ * \param zone
+ *      Zone map of a chunk
+ * \param range
+ *      Query range
+ * \return
+ *      true when the chunk may hold samples in the range
+ */
+static bool overlaps(const BMX280_ArchiveRange_t &zone, const BMX280_ArchiveRange_t &range)
+{
+    return (zone.timeFrom <= range.timeTo) && (zone.timeTo >= range.timeFrom) &&
+           (zone.temperatureMin <= range.temperatureMax) &&
+           (zone.temperatureMax >= range.temperatureMin) &&
+           (zone.pressureMin <= range.pressureMax) && (zone.pressureMax >= range.pressureMin) &&
+           (zone.humidityMin <= range.humidityMax) && (zone.humidityMax >= range.humidityMin);
+}
+
+/*!
+ * \brief Check if a sample is within a query range
+ * \param sample
+ *      Sample
+ * \param range
+ *      Query range
+ * \return
+ *      true when all columns are in range
+ */
+static bool inRange(const BMX280_ArchiveSample_t &sample, const BMX280_ArchiveRange_t &range)
+{
+    return (sample.timestamp >= range.timeFrom) && (sample.timestamp <= range.timeTo) &&
+           (sample.temperature >= range.temperatureMin) &&
+           (sample.temperature <= range.temperatureMax) &&
+           (sample.pressure >= range.pressureMin) && (sample.pressure <= range.pressureMax) &&
+           (sample.humidity >= range.humidityMin) && (sample.humidity <= range.humidityMax);
+}
+
+/*!
+ * \brief Set a range to all values
+ * \details
+ *      Start of a query: set all, then narrow the columns to filter.
+ * \param range
+ *      Range
+ */
+void bmx280ArchiveRangeAll(BMX280_ArchiveRange_t *range)
+{
+    range->timeFrom = 0;
+    range->timeTo = 0xFFFFFFFFUL;
+    range->temperatureMin = INT32_MIN;
+    range->temperatureMax = INT32_MAX;
+    range->pressureMin = 0;
+    range->pressureMax = 0xFFFFFFFFUL;
+    range->humidityMin = 0;
+    range->humidityMax = 0xFFFFFFFFUL;
+}
+
+/*!
+ * \brief Constructor
+ * \param storage
+ *      Storage
+ * \param samples
+ *      Sample buffer, must outlive the archive
+ * \param maxSamples
+ *      Size of the sample buffer, limits the samples per chunk
+ * \param chunkSize
+ *      Chunk size in bytes, at least BMX280_ARCHIVE_MIN_CHUNK. Use the flash erase
+ *      size. About 5 bytes per sample for slowly changing values
+ * \param offset
+ *      Start of the archive region in bytes, chunk aligned for flash
+ * \param length
+ *      Length of the archive region in bytes, 0 = until end of storage
+ */
+ErriezBMX280Archive::ErriezBMX280Archive(ErriezBMX280Storage *storage,
+                                         BMX280_ArchiveSample_t *samples, uint8_t maxSamples,
+                                         uint16_t chunkSize, uint32_t offset, uint32_t length) :
+    _storage(storage), _samples(samples), _maxSamples(maxSamples), _chunkSize(chunkSize),
+    _offset(offset), _length(length), _capacity(0), _chunks(0), _written(0), _buffered(0),
+    _lastTimestamp(0), _chunksRead(0), _samplesRead(0), _readErrors(0)
+{
+    memset(_columnLength, 0, sizeof(_columnLength));
+    bmx280ArchiveRangeAll(&_zone);
+}
+
+/*!
+ * \brief Find the end of the archive after reset or power loss
+ * \details
+ *      Written chunks are followed by unwritten chunks, a chunk torn by power loss
+ *      fails its CRC. A binary search finds the first invalid chunk. Discards the
+ *      sample buffer.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Invalid chunk size, empty sample buffer or region smaller than one chunk
+ */
+bool ErriezBMX280Archive::begin()
+{
+    BMX280_ArchiveChunk_t header;
+    uint32_t length = _length;
+    uint16_t lo = 0;
+    uint16_t hi;
+
+    if (length == 0) {
+        length = _storage->size() - _offset;
+    }
+    _capacity = ((length / _chunkSize) > 0xFFFF) ? 0xFFFF : (length / _chunkSize);
+    if ((_chunkSize < BMX280_ARCHIVE_MIN_CHUNK) || (_maxSamples == 0) || (_capacity == 0)) {
+        _capacity = 0;
+        return false;
+    }
+
+    hi = _capacity;
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+
+        if (readChunk(mid, &header)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    _chunks = lo;
+    _written = 0;
+    _buffered = 0;
+    _lastTimestamp = 0;
+    if (_chunks && readHeader(_chunks - 1, &header)) {
+        _written = header.first + header.count;
+        _lastTimestamp = header.zone.timeTo;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Erase all chunks
+ * \details
+ *      Required once for storage holding other data, which could pass the CRC.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Erase or write failed, or begin() failed
+ */
+bool ErriezBMX280Archive::format()
+{
+    uint8_t erased[BMX280_ARCHIVE_HEADER_LEN];
+
+    if ((_capacity == 0) && !begin()) {
+        return false;
+    }
+
+    memset(erased, 0xFF, sizeof(erased));
+    for (uint16_t chunk = 0; chunk < _capacity; chunk++) {
+        if (!_storage->erase(chunkAddress(chunk), _chunkSize) ||
+            !_storage->write(chunkAddress(chunk), erased, sizeof(erased))) {
+            return false;
+        }
+    }
+
+    _chunks = 0;
+    _written = 0;
+    _buffered = 0;
+    _lastTimestamp = 0;
+
+    return _storage->sync();
+}
+
+/*!
+ * \brief Append sample, writes the buffered chunk when the sample does not fit
+ * \param sample
+ *      Sample, timestamps must not decrease
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Archive full, not initialized, decreasing timestamp or write failed
+ */
+bool ErriezBMX280Archive::append(const BMX280_ArchiveSample_t &sample)
+{
+    static const BMX280_ArchiveSample_t zero = { 0, 0, 0, 0 };
+    uint16_t length[BMX280_ARCHIVE_COLUMNS];
+    uint16_t used = 0;
+    uint16_t needed = 0;
+
+    if ((_capacity == 0) || (sample.timestamp < _lastTimestamp)) {
+        return false;
+    }
+
+    for (uint8_t column = 0; column < BMX280_ARCHIVE_COLUMNS; column++) {
+        length[column] = varintLength(encodeColumn(&sample, _buffered ?
+                                                   &_samples[_buffered - 1] : &zero, column));
+        used += _columnLength[column];
+        needed += length[column];
+    }
+
+    // Close the chunk
+    if (_buffered && ((_buffered == _maxSamples) ||
+                      ((used + needed) > (_chunkSize - BMX280_ARCHIVE_HEADER_LEN)))) {
+        if (!writeChunk()) {
+            return false;
+        }
+        for (uint8_t column = 0; column < BMX280_ARCHIVE_COLUMNS; column++) {
+            length[column] = varintLength(encodeColumn(&sample, &zero, column));
+        }
+    }
+
+    if (_buffered == 0) {
+        memset(_columnLength, 0, sizeof(_columnLength));
+        _zone.timeFrom = sample.timestamp;
+        _zone.temperatureMin = _zone.temperatureMax = sample.temperature;
+        _zone.pressureMin = _zone.pressureMax = sample.pressure;
+        _zone.humidityMin = _zone.humidityMax = sample.humidity;
+    } else {
+        if (sample.temperature < _zone.temperatureMin) {
+            _zone.temperatureMin = sample.temperature;
+        }
+        if (sample.temperature > _zone.temperatureMax) {
+            _zone.temperatureMax = sample.temperature;
+        }
+        if (sample.pressure < _zone.pressureMin) {
+            _zone.pressureMin = sample.pressure;
+        }
+        if (sample.pressure > _zone.pressureMax) {
+            _zone.pressureMax = sample.pressure;
+        }
+        if (sample.humidity < _zone.humidityMin) {
+            _zone.humidityMin = sample.humidity;
+        }
+        if (sample.humidity > _zone.humidityMax) {
+            _zone.humidityMax = sample.humidity;
+        }
+    }
+    _zone.timeTo = sample.timestamp;
+
+    for (uint8_t column = 0; column < BMX280_ARCHIVE_COLUMNS; column++) {
+        _columnLength[column] += length[column];
+    }
+    _samples[_buffered++] = sample;
+    _lastTimestamp = sample.timestamp;
+
+    return true;
+}
+
+/*!
+ * \brief Compensate and append sample
+ * \param sample
+ *      Sample, invalid samples are ignored
+ * \param timestamp
+ *      Application time, for example RTC seconds, must not decrease
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Invalid sample, archive full, not initialized, decreasing timestamp or
+ *      write failed
+ */
+bool ErriezBMX280Archive::append(ErriezBMX280Sample &sample, uint32_t timestamp)
+{
+    BMX280_ArchiveSample_t s;
+
+    if (!sample.isValid()) {
+        return false;
+    }
+
+    s.timestamp = timestamp;
+    s.temperature = sample.getTemperatureNative();
+    s.pressure = sample.getPressureNative();
+    s.humidity = sample.hasHumidity() ? sample.getHumidityNative() : 0;
+
+    return append(s);
+}
+
+/*!
+ * \brief Write a partially filled chunk
+ * \details
+ *      Call before a planned power down. The samples occupy a complete chunk.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Archive full or write failed
+ */
+bool ErriezBMX280Archive::flush()
+{
+    if (_buffered == 0) {
+        return _storage->sync();
+    }
+
+    return writeChunk();
+}
+
+/*!
+ * \brief Get number of samples
+ * \return
+ *      Number of samples in storage and sample buffer
+ */
+uint32_t ErriezBMX280Archive::count()
+{
+    return _written + _buffered;
+}
+
+/*!
+ * \brief Get number of written chunks
+ * \return
+ *      Number of chunks
+ */
+uint16_t ErriezBMX280Archive::getChunks()
+{
+    return _chunks;
+}
+
+/*!
+ * \brief Get number of chunks in the region
+ * \return
+ *      Number of chunks, 0 before begin()
+ */
+uint16_t ErriezBMX280Archive::getCapacity()
+{
+    return _capacity;
+}
+
+/*!
+ * \brief Query samples within a range
+ * \details
+ *      Only chunks in the time range whose zone map overlaps the range are decoded,
+ *      the sample buffer is searched last. The CRC of each decoded chunk is checked.
+ *      Chunks which cannot be read or have a CRC mismatch are skipped and counted by
+ *      getReadErrors(), the result is incomplete in that case.
+ * \param range
+ *      Inclusive ranges of all columns, see bmx280ArchiveRangeAll()
+ * \param callback
+ *      Called for each sample in the range, oldest first, NULL = count only
+ * \return
+ *      Number of samples in the range
+ */
+uint32_t ErriezBMX280Archive::query(const BMX280_ArchiveRange_t &range,
+                                    BMX280_ArchiveCallback callback)
+{
+    BMX280_ArchiveChunk_t header;
+    uint32_t matches = 0;
+    uint16_t lo = 0;
+    uint16_t hi = _chunks;
+
+    _chunksRead = 0;
+    _samplesRead = 0;
+    _readErrors = 0;
+
+    // Binary search for the first chunk ending at or after the start of the range
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+
+        if (readHeader(mid, &header) && (header.zone.timeTo < range.timeFrom)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    for (uint16_t chunk = lo; chunk < _chunks; chunk++) {
+        if (!readHeader(chunk, &header)) {
+            _readErrors++;
+            continue;
+        }
+        if (header.zone.timeFrom > range.timeTo) {
+            break;
+        }
+        if (overlaps(header.zone, range)) {
+            // Check the CRC before any sample of the chunk reaches the callback
+            if (!readChunk(chunk, &header)) {
+                _readErrors++;
+                continue;
+            }
+            _chunksRead++;
+            matches += scanChunk(chunk, &header, range, callback);
+        }
+    }
+
+    for (uint8_t i = 0; i < _buffered; i++) {
+        if (inRange(_samples[i], range)) {
+            if (callback) {
+                callback(_samples[i]);
+            }
+            matches++;
+        }
+    }
+
+    return matches;
+}
+
+/*!
+ * \brief Get timestamp of the newest sample
+ * \details
+ *      append() refuses older samples.
+ * \return
+ *      Timestamp, 0 when empty
+ */
+uint32_t ErriezBMX280Archive::getLastTimestamp()
+{
+    return _lastTimestamp;
+}
+
+/*!
+ * \brief Get number of chunks decoded by the last query
+ * \details
+ *      Diagnostics: the other chunks were skipped by the zone maps.
+ * \return
+ *      Number of chunks
+ */
+uint16_t ErriezBMX280Archive::getChunksRead()
+{
+    return _chunksRead;
+}
+
+/*!
+ * \brief Get number of samples in the chunks decoded by the last query
+ * \details
+ *      Diagnostics: the samples scanned, within the range of the query or not.
+ * \return
+ *      Number of samples
+ */
+uint32_t ErriezBMX280Archive::getSamplesRead()
+{
+    return _samplesRead;
+}
+
+/*!
+ * \brief Get number of chunks the last query could not read
+ * \details
+ *      A header or column read failed, the header is invalid or the CRC of the header
+ *      and columns does not match. The samples of these chunks are missing in the
+ *      result of the query.
+ * \return
+ *      Number of chunks, 0 = complete result
+ */
+uint16_t ErriezBMX280Archive::getReadErrors()
+{
+    return _readErrors;
+}
+
+/*!
+ * \brief Write sample buffer to the next chunk
+ * \details
+ *      Erase, columns, header: the header completes the chunk.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Archive full, erase or write failed, the sample buffer is kept
+ */
+bool ErriezBMX280Archive::writeChunk()
+{
+    static const BMX280_ArchiveSample_t zero = { 0, 0, 0, 0 };
+    BMX280_ArchiveChunk_t header;
+    ArchiveWriter_t w;
+
+    if (_chunks >= _capacity) {
+        return false;
+    }
+
+    memset(&header, 0xFF, sizeof(header));
+    header.count = _buffered;
+    memcpy(header.columnLength, _columnLength, sizeof(header.columnLength));
+    header.first = _written;
+    header.zone = _zone;
+
+    w.storage = _storage;
+    w.addr = chunkAddress(_chunks) + BMX280_ARCHIVE_HEADER_LEN;
+    w.crc = bmx280Crc16((const uint8_t *)&header + 2, BMX280_ARCHIVE_HEADER_LEN - 2);
+    w.len = 0;
+
+    if (!_storage->erase(chunkAddress(_chunks), _chunkSize)) {
+        return false;
+    }
+
+    // One column after the other
+    for (uint8_t column = 0; column < BMX280_ARCHIVE_COLUMNS; column++) {
+        for (uint8_t i = 0; i < _buffered; i++) {
+            uint32_t value = encodeColumn(&_samples[i], i ? &_samples[i - 1] : &zero, column);
+
+            while (value >= 0x80) {
+                if (!writerPut(&w, (value & 0x7F) | 0x80)) {
+                    return false;
+                }
+                value >>= 7;
+            }
+            if (!writerPut(&w, value)) {
+                return false;
+            }
+        }
+    }
+
+    header.crc = w.crc;
+    if (!writerFlush(&w) ||
+        !_storage->write(chunkAddress(_chunks), (const uint8_t *)&header,
+                         BMX280_ARCHIVE_HEADER_LEN) ||
+        !_storage->sync()) {
+        return false;
+    }
+
+    _chunks++;
+    _written += _buffered;
+    _buffered = 0;
+
+    return true;
+}
+
+/*!
+ * \brief Get storage address of a chunk
+ * \param chunk
+ *      Chunk index
+ * \return
+ *      Address
+ */
+uint32_t ErriezBMX280Archive::chunkAddress(uint16_t chunk)
+{
+    return _offset + (uint32_t)chunk * _chunkSize;
+}
+
+/*!
+ * \brief Read a chunk header without checking the columns
+ * \param chunk
+ *      Chunk index
+ * \param header
+ *      Header
+ * \retval true
+ *      Header read, sample count and column lengths in range
+ * \retval false
+ *      Read failed or invalid header
+ */
+bool ErriezBMX280Archive::readHeader(uint16_t chunk, BMX280_ArchiveChunk_t *header)
+{
+    uint32_t length = 0;
+
+    if (!_storage->read(chunkAddress(chunk), (uint8_t *)header, BMX280_ARCHIVE_HEADER_LEN)) {
+        return false;
+    }
+
+    for (uint8_t column = 0; column < BMX280_ARCHIVE_COLUMNS; column++) {
+        length += header->columnLength[column];
+    }
+
+    return (header->count > 0) && (length <= (uint32_t)(_chunkSize - BMX280_ARCHIVE_HEADER_LEN));
+}
+
+/*!
+ * \brief Read and check a complete chunk
+ * \param chunk
+ *      Chunk index
+ * \param header
+ *      Header
+ * \retval true
+ *      Valid chunk
+ * \retval false
+ *      Read failed or no valid chunk
+ */
+bool ErriezBMX280Archive::readChunk(uint16_t chunk, BMX280_ArchiveChunk_t *header)
+{
+    uint8_t buf[16];
+    uint32_t addr = chunkAddress(chunk) + BMX280_ARCHIVE_HEADER_LEN;
+    uint16_t length = 0;
+    uint16_t crc;
+
+    if (!readHeader(chunk, header)) {
+        return false;
+    }
+
+    for (uint8_t column = 0; column < BMX280_ARCHIVE_COLUMNS; column++) {
+        length += header->columnLength[column];
+    }
+
+    crc = bmx280Crc16((const uint8_t *)header + 2, BMX280_ARCHIVE_HEADER_LEN - 2);
+    while (length) {
+        uint8_t len = (length < sizeof(buf)) ? length : sizeof(buf);
+
+        if (!_storage->read(addr, buf, len)) {
+            return false;
+        }
+        crc = bmx280Crc16(buf, len, crc);
+        addr += len;
+        length -= len;
+    }
+
+    return crc == header->crc;
+}
+
+/*!
+ * \brief Decode a chunk and call the callback for samples in the range
+ * \details
+ *      The columns are read in parallel, one cursor per column.
+ * \param chunk
+ *      Chunk index
+ * \param header
+ *      Header of the chunk
+ * \param range
+ *      Query range
+ * \param callback
+ *      Callback, NULL = count only
+ * \return
+ *      Number of samples in the range
+ */
+uint32_t ErriezBMX280Archive::scanChunk(uint16_t chunk, const BMX280_ArchiveChunk_t *header,
+                                        const BMX280_ArchiveRange_t &range,
+                                        BMX280_ArchiveCallback callback)
+{
+    ArchiveCursor_t cursors[BMX280_ARCHIVE_COLUMNS];
+    BMX280_ArchiveSample_t prev = { 0, 0, 0, 0 };
+    BMX280_ArchiveSample_t sample;
+    uint32_t addr = chunkAddress(chunk) + BMX280_ARCHIVE_HEADER_LEN;
+    uint32_t matches = 0;
+
+    for (uint8_t column = 0; column < BMX280_ARCHIVE_COLUMNS; column++) {
+        cursors[column].addr = addr;
+        cursors[column].remaining = header->columnLength[column];
+        cursors[column].pos = 0;
+        cursors[column].len = 0;
+        addr += header->columnLength[column];
+    }
+
+    for (uint8_t i = 0; i < header->count; i++) {
+        for (uint8_t column = 0; column < BMX280_ARCHIVE_COLUMNS; column++) {
+            uint32_t value;
+
+            if (!cursorGet(_storage, &cursors[column], &value)) {
+                _readErrors++;
+                return matches;
+            }
+            decodeColumn(&sample, &prev, column, value);
+        }
+        _samplesRead++;
+
+        if (inRange(sample, range)) {
+            if (callback) {
+                callback(sample);
+            }
+            matches++;
+        }
+        prev = sample;
+    }
+
+    return matches;
+}
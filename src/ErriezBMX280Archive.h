@@ -0,0 +1,165 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Archive.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Columnar archive of compensated samples with zone maps for range queries
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_ARCHIVE_H_
+#define ERRIEZ_BMX280_ARCHIVE_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Sample.h"
+#include "ErriezBMX280Storage.h"
+
+#define BMX280_ARCHIVE_COLUMNS      4       //!< Timestamp, temperature, pressure, humidity
+#define BMX280_ARCHIVE_HEADER_LEN   48      //!< Chunk header length in bytes
+#define BMX280_ARCHIVE_MIN_CHUNK    68      //!< Minimum chunk size: header and one sample
+
+/*!
+ * \brief Archived sample in native fixed-point units
+ */
+typedef struct {
+    uint32_t timestamp;         //!< Application time, for example RTC seconds
+    int32_t temperature;        //!< Temperature 0.01 degree Celsius
+    uint32_t pressure;          //!< Pressure Pa 24.8
+    uint32_t humidity;          //!< Humidity % 22.10, 0 without humidity
+} BMX280_ArchiveSample_t;
+
+/*!
+ * \brief Inclusive value ranges of all columns
+ * \details
+ *      Zone map of a chunk and filter of a query.
+ */
+typedef struct {
+    uint32_t timeFrom;          //!< First timestamp
+    uint32_t timeTo;            //!< Last timestamp
+    int32_t temperatureMin;     //!< Temperature 0.01 degree Celsius
+    int32_t temperatureMax;     //!< Temperature 0.01 degree Celsius
+    uint32_t pressureMin;       //!< Pressure Pa 24.8
+    uint32_t pressureMax;       //!< Pressure Pa 24.8
+    uint32_t humidityMin;       //!< Humidity % 22.10
+    uint32_t humidityMax;       //!< Humidity % 22.10
+} BMX280_ArchiveRange_t;
+
+/*!
+ * \brief Archive chunk header
+ * \details
+ *      48 bytes without padding, little-endian, at the start of each chunk followed
+ *      by the columns. Each column holds the differences to the previous value of the
+ *      column, the first to 0, zigzag and varint encoded: 7 bits per byte, least
+ *      significant first, bit 7 set when more bytes follow. Timestamps are not
+ *      zigzag encoded, they do not decrease. The CRC covers the rest of the header
+ *      and the columns. The header is written after the columns.
+ */
+typedef struct {
+    uint16_t crc;               //!< CRC-16/CCITT of the header from count and the columns
+    uint8_t count;              //!< Number of samples
+    uint8_t reserved;           //!< 0xFF
+    uint16_t columnLength[BMX280_ARCHIVE_COLUMNS];  //!< Encoded column lengths in bytes
+    uint32_t first;             //!< Number of samples in previous chunks
+    BMX280_ArchiveRange_t zone; //!< Zone map: value ranges of the chunk
+} BMX280_ArchiveChunk_t;
+
+/*!
+ * \brief Query callback
+ * \param sample
+ *      Sample within the range of the query, oldest first
+ */
+typedef void (*BMX280_ArchiveCallback)(const BMX280_ArchiveSample_t &sample);
+
+void bmx280ArchiveRangeAll(BMX280_ArchiveRange_t *range);
+
+/*!
+ * \brief BMX280 archive class
+ * \details
+ *      Append-only store of compensated samples in fixed-size chunks. Samples are
+ *      collected in a buffer provided by the application and written as one chunk
+ *      of columns when the next sample does not fit. Each chunk header holds a zone
+ *      map with the value ranges of its samples. A query finds the first chunk of its
+ *      time range with a binary search and skips chunks whose zone map is outside
+ *      the query range without reading the columns.
+ */
+class ErriezBMX280Archive
+{
+public:
+    // Constructor
+    ErriezBMX280Archive(ErriezBMX280Storage *storage, BMX280_ArchiveSample_t *samples,
+                        uint8_t maxSamples, uint16_t chunkSize = 256,
+                        uint32_t offset = 0, uint32_t length = 0);
+
+    // Initialization
+    bool begin();
+    bool format();
+
+    // Store
+    bool append(const BMX280_ArchiveSample_t &sample);
+    bool append(ErriezBMX280Sample &sample, uint32_t timestamp);
+    bool flush();
+
+    // Query
+    uint32_t count();
+    uint16_t getChunks();
+    uint16_t getCapacity();
+    uint32_t getLastTimestamp();
+    uint32_t query(const BMX280_ArchiveRange_t &range, BMX280_ArchiveCallback callback);
+    uint16_t getChunksRead();
+    uint32_t getSamplesRead();
+    uint16_t getReadErrors();
+
+private:
+    ErriezBMX280Storage *_storage;      //!< Storage
+    BMX280_ArchiveSample_t *_samples;   //!< Sample buffer of the chunk being collected
+    uint8_t _maxSamples;                //!< Size of the sample buffer
+    uint16_t _chunkSize;                //!< Chunk size in bytes
+    uint32_t _offset;                   //!< Start of the archive region in bytes
+    uint32_t _length;                   //!< Length of the archive region, 0 = until end
+    uint16_t _capacity;                 //!< Number of chunks in the region
+    uint16_t _chunks;                   //!< Number of written chunks
+    uint32_t _written;                  //!< Number of samples in written chunks
+    uint8_t _buffered;                  //!< Number of samples in the buffer
+    uint16_t _columnLength[BMX280_ARCHIVE_COLUMNS]; //!< Encoded column lengths of the buffer
+    BMX280_ArchiveRange_t _zone;        //!< Zone map of the buffer
+    uint32_t _lastTimestamp;            //!< Last appended timestamp
+    uint16_t _chunksRead;               //!< Chunks decoded by the last query
+    uint32_t _samplesRead;              //!< Samples decoded by the last query
+    uint16_t _readErrors;               //!< Unreadable chunks of the last query
+
+    bool writeChunk();
+    uint32_t chunkAddress(uint16_t chunk);
+    bool readHeader(uint16_t chunk, BMX280_ArchiveChunk_t *header);
+    bool readChunk(uint16_t chunk, BMX280_ArchiveChunk_t *header);
+    uint32_t scanChunk(uint16_t chunk, const BMX280_ArchiveChunk_t *header,
+                       const BMX280_ArchiveRange_t &range, BMX280_ArchiveCallback callback);
+};
+
+#endif // ERRIEZ_BMX280_ARCHIVE_H_
@@ -0,0 +1,119 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Bus.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Bus interface to replace the built-in Wire access
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_BUS_H_
+#define ERRIEZ_BMX280_BUS_H_
+
+#include <Arduino.h>
+
+/*!
+ * \brief BMX280 bus interface class
+ * \details
+ *      Optional: sensors constructed without bus interface use Wire. Implement this
+ *      interface for other buses or for a mock bus without hardware.
+ */
+class ErriezBMX280Bus
+{
+public:
+    /*!
+     * \brief Destructor, allows deleting a bus through a base class pointer
+     */
+    virtual ~ErriezBMX280Bus() { }
+
+    /*!
+     * \brief Burst read from consecutive registers
+     * \param addr
+     *      Device address
+     * \param reg
+     *      First register address
+     * \param buffer
+     *      Buffer to store register values
+     * \param len
+     *      Number of registers
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Bus transfer failed
+     */
+    virtual bool read(uint8_t addr, uint8_t reg, uint8_t *buffer, uint8_t len) = 0;
+
+    /*!
+     * \brief Write to 8-bit register
+     * \param addr
+     *      Device address
+     * \param reg
+     *      Register address
+     * \param value
+     *      8-bit register value
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Bus transfer failed
+     */
+    virtual bool write(uint8_t addr, uint8_t reg, uint8_t value) = 0;
+
+    /*!
+     * \brief Burst read the same registers of several devices
+     * \details
+     *      Default: one read() per device. Override when the bus can combine the
+     *      transfers, for example in one bus transaction.
+     * \param addrs
+     *      Device addresses
+     * \param count
+     *      Number of devices
+     * \param reg
+     *      First register address
+     * \param buffer
+     *      Buffer to store register values: count * len bytes, in addrs order
+     * \param len
+     *      Number of registers per device
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Bus transfer failed
+     */
+    virtual bool readBatch(const uint8_t *addrs, uint8_t count, uint8_t reg,
+                           uint8_t *buffer, uint8_t len)
+    {
+        for (uint8_t i = 0; i < count; i++) {
+            if (!read(addrs[i], reg, &buffer[i * len], len)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+#endif // ERRIEZ_BMX280_BUS_H_
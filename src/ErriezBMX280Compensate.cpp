@@ -0,0 +1,399 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Compensate.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Integer compensation formulas, see datasheet 4.2.3 Compensation formulas
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280Compensate.h"
+#include "ErriezBMX280Kernels.h"
+
+// Pressure cache flags
+#define PRESSURE_CACHE_VALID    (1 << 0)    //!< Terms hold values for t_fine
+#define PRESSURE_CACHE_PREINV   (1 << 1)    //!< Divisor fits in 32 bits, reciprocal valid
+
+/*!
+ * \brief Divide 64-bit by 32-bit with precomputed reciprocal
+ * \details
+ *      See Moller, Granlund: Improved division by invariant integers, algorithm 4.
+ * \param u1
+ *      Numerator high, must be less than d
+ * \param u0
+ *      Numerator low
+ * \param d
+ *      Normalized divisor, most significant bit set
+ * \param v
+ *      Reciprocal floor((2^64 - 1) / d) - 2^32
+ * \param r
+ *      Output: remainder
+ * \return
+ *      Quotient
+ */
+static uint32_t divPreinv(uint32_t u1, uint32_t u0, uint32_t d, uint32_t v, uint32_t *r)
+{
+    uint64_t q = ((uint64_t)v * u1) + (((uint64_t)u1 << 32) | u0);
+    uint32_t q1 = (uint32_t)(q >> 32) + 1;
+    uint32_t q0 = (uint32_t)q;
+    uint32_t rem = u0 - (q1 * d);
+
+    if (rem > q0) {
+        q1--;
+        rem += d;
+    }
+    if (rem >= d) {
+        q1++;
+        rem -= d;
+    }
+
+    *r = rem;
+    return q1;
+}
+
+/*!
+ * \brief Calculate reciprocal of a normalized divisor with 32-bit divisions
+ * \details
+ *      Divides 2^64 - 1 - 2^32 * d by d in two steps of 16 quotient bits, each with a
+ *      32-bit division by the high half of d and at most two corrections, see Knuth,
+ *      TAOCP Vol. 2, 4.3.1 algorithm D. Replaces the 64-bit library division, the
+ *      32-bit division is one instruction on Cortex-M3 and later.
+ * \param d
+ *      Normalized divisor, most significant bit set
+ * \return
+ *      Reciprocal floor((2^64 - 1) / d) - 2^32
+ */
+static uint32_t reciprocal(uint32_t d)
+{
+    uint32_t dh = d >> 16;
+    uint32_t dl = d & 0xFFFF;
+    uint32_t q1;
+    uint32_t q0;
+    uint32_t r;
+    uint32_t m;
+
+    // Numerator high word ~d is below d, so the quotient fits in 32 bits
+    q1 = ~d / dh;
+    r = ~d - (q1 * dh);
+    m = q1 * dl;
+    r = (r << 16) | 0xFFFF;
+    if (r < m) {
+        q1--;
+        r += d;
+        // No carry out of r: the estimate can be one too high again
+        if ((r >= d) && (r < m)) {
+            q1--;
+            r += d;
+        }
+    }
+    r -= m;
+
+    q0 = r / dh;
+    r = r - (q0 * dh);
+    m = q0 * dl;
+    r = (r << 16) | 0xFFFF;
+    if (r < m) {
+        q0--;
+        r += d;
+        if ((r >= d) && (r < m)) {
+            q0--;
+        }
+    }
+
+    return (q1 << 16) | q0;
+}
+
+/*!
+ * \brief Calculate pressure terms which depend on t_fine only
+ * \param calib
+ *      Compensation coefficients
+ * \param cache
+ *      Output: pressure terms
+ * \param t_fine
+ *      Fine temperature from bmx280CompensateT()
+ */
+static void pressureCacheUpdate(const BMX280_Calib_t *calib, BMX280_PressureCache_t *cache,
+                                int32_t t_fine)
+{
+    int64_t var1;
+    int64_t var2;
+    uint32_t d;
+
+    // See datasheet 4.2.3 Compensation formulas
+    var1 = ((int64_t)t_fine) - 128000;
+    var2 = var1 * var1 * (int64_t)calib->dig_P6;
+    var2 = var2 + ((var1 * (int64_t)calib->dig_P5) << 17);
+    var2 = var2 + (((int64_t)calib->dig_P4) << 35);
+    var1 = ((var1 * var1 * (int64_t)calib->dig_P3) >> 8) + ((var1 * (int64_t)calib->dig_P2) << 12);
+    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)calib->dig_P1) >> 33;
+
+    cache->var1 = var1;
+    cache->var2 = var2;
+    cache->t_fine = t_fine;
+    cache->flags = PRESSURE_CACHE_VALID;
+
+    // Divisor is positive and below 2^31 for all valid coefficients
+    if ((var1 > 0) && (var1 <= 0xFFFFFFFFLL)) {
+        d = (uint32_t)var1;
+        cache->shift = 0;
+        while (!(d & 0x80000000UL)) {
+            d <<= 1;
+            cache->shift++;
+        }
+        cache->divisor = d;
+        cache->reciprocal = reciprocal(d);
+        cache->flags |= PRESSURE_CACHE_PREINV;
+    }
+}
+
+/*!
+ * \brief Compensate temperature
+ * \param calib
+ *      Compensation coefficients
+ * \param adc_T
+ *      20-bit uncompensated temperature
+ * \param t_fine
+ *      Output: fine temperature, used by pressure and humidity compensation
+ * \return
+ *      Temperature in 0.01 degree Celsius
+ */
+int32_t bmx280CompensateT(const BMX280_Calib_t *calib, int32_t adc_T, int32_t *t_fine)
+{
+    int32_t var1, var2;
+
+    var1 = ((((adc_T >> 3) - ((int32_t)calib->dig_T1 << 1))) * ((int32_t)calib->dig_T2)) >> 11;
+
+    var2 = (((((adc_T >> 4) - ((int32_t)calib->dig_T1)) *
+            ((adc_T >> 4) - ((int32_t)calib->dig_T1))) >> 12) *
+            ((int32_t)calib->dig_T3)) >> 14;
+
+    *t_fine = var1 + var2;
+
+    return ((*t_fine * 5) + 128) >> 8;
+}
+
+/*!
+ * \brief Compensate temperature with architecture specific multiplications
+ * \details
+ *      Bit-exact with bmx280CompensateT().
+ * \param calib
+ *      Compensation coefficients
+ * \param adc_T
+ *      20-bit uncompensated temperature
+ * \param t_fine
+ *      Output: fine temperature, used by pressure and humidity compensation
+ * \return
+ *      Temperature in 0.01 degree Celsius
+ */
+int32_t bmx280CompensateTFast(const BMX280_Calib_t *calib, int32_t adc_T, int32_t *t_fine)
+{
+    int32_t var1, var2;
+
+    var1 = bmx280MulS32S16((adc_T >> 3) - ((int32_t)calib->dig_T1 << 1), calib->dig_T2) >> 11;
+
+    var2 = bmx280MulS32S16(bmx280SqrS32((adc_T >> 4) - ((int32_t)calib->dig_T1)) >> 12,
+                           calib->dig_T3) >> 14;
+
+    *t_fine = var1 + var2;
+
+    return ((*t_fine * 5) + 128) >> 8;
+}
+
+/*!
+ * \brief Compensate pressure
+ * \param calib
+ *      Compensation coefficients
+ * \param adc_P
+ *      20-bit uncompensated pressure
+ * \param t_fine
+ *      Fine temperature from bmx280CompensateT()
+ * \return
+ *      Pressure in Pa as unsigned 24.8 fixed-point, 0 on invalid coefficients
+ */
+uint32_t bmx280CompensateP(const BMX280_Calib_t *calib, int32_t adc_P, int32_t t_fine)
+{
+    int64_t var1;
+    int64_t var2;
+    int64_t p;
+
+    var1 = ((int64_t)t_fine) - 128000;
+    var2 = var1 * var1 * (int64_t)calib->dig_P6;
+    var2 = var2 + ((var1 * (int64_t)calib->dig_P5) << 17);
+    var2 = var2 + (((int64_t)calib->dig_P4) << 35);
+    var1 = ((var1 * var1 * (int64_t)calib->dig_P3) >> 8) + ((var1 * (int64_t)calib->dig_P2) << 12);
+    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)calib->dig_P1) >> 33;
+
+    if (var1 == 0) {
+        return 0; // avoid exception caused by division by zero
+    }
+    p = 1048576 - adc_P;
+    p = (((p << 31) - var2) * 3125) / var1;
+    var1 = (((int64_t)calib->dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (((int64_t)calib->dig_P8) * p) >> 19;
+
+    p = ((p + var1 + var2) >> 8) + (((int64_t)calib->dig_P7) << 4);
+
+    return (uint32_t)p;
+}
+
+/*!
+ * \brief Compensate pressure without 64-bit division
+ * \details
+ *      Bit-exact with bmx280CompensateP(). The terms depending on t_fine are calculated
+ *      once per t_fine value and the division is done with a cached reciprocal.
+ * \param calib
+ *      Compensation coefficients
+ * \param cache
+ *      Pressure terms, updated when t_fine changes
+ * \param adc_P
+ *      20-bit uncompensated pressure
+ * \param t_fine
+ *      Fine temperature from bmx280CompensateT()
+ * \return
+ *      Pressure in Pa as unsigned 24.8 fixed-point, 0 on invalid coefficients
+ */
+uint32_t bmx280CompensatePCached(const BMX280_Calib_t *calib, BMX280_PressureCache_t *cache,
+                                 int32_t adc_P, int32_t t_fine)
+{
+    int64_t var1;
+    int64_t var2;
+    int64_t p;
+    int64_t n;
+
+    if (!(cache->flags & PRESSURE_CACHE_VALID) || (cache->t_fine != t_fine)) {
+        pressureCacheUpdate(calib, cache, t_fine);
+    }
+
+    if (cache->var1 == 0) {
+        return 0; // avoid exception caused by division by zero
+    }
+    p = 1048576 - adc_P;
+    n = bmx280MulS64S16((p << 31) - cache->var2, 3125);
+
+    if (cache->flags & PRESSURE_CACHE_PREINV) {
+        // Long division of |n| << shift in 32-bit limbs, truncated towards zero
+        uint64_t un = (n < 0) ? (0 - (uint64_t)n) : (uint64_t)n;
+        uint8_t s = cache->shift;
+        uint32_t u2 = s ? (uint32_t)(un >> (64 - s)) : 0;
+        uint32_t u1 = (uint32_t)(un >> (32 - s));
+        uint32_t u0 = (uint32_t)(un << s);
+        uint32_t qh, ql, r;
+        uint64_t q;
+
+        qh = divPreinv(u2, u1, cache->divisor, cache->reciprocal, &r);
+        ql = divPreinv(r, u0, cache->divisor, cache->reciprocal, &r);
+        q = ((uint64_t)qh << 32) | ql;
+        p = (n < 0) ? -(int64_t)q : (int64_t)q;
+    } else {
+        p = n / cache->var1;
+    }
+
+    var1 = bmx280MulS64S16(bmx280SqrS64(p >> 13), calib->dig_P9) >> 25;
+    var2 = bmx280MulS64S16(p, calib->dig_P8) >> 19;
+
+    p = ((p + var1 + var2) >> 8) + (((int64_t)calib->dig_P7) << 4);
+
+    return (uint32_t)p;
+}
+
+/*!
+ * \brief Invalidate pressure terms, required after changing the coefficients
+ * \param cache
+ *      Pressure terms
+ */
+void bmx280PressureCacheReset(BMX280_PressureCache_t *cache)
+{
+    cache->flags = 0;
+}
+
+/*!
+ * \brief Compensate humidity (BME280 only)
+ * \param calib
+ *      Compensation coefficients
+ * \param adc_H
+ *      16-bit uncompensated humidity
+ * \param t_fine
+ *      Fine temperature from bmx280CompensateT()
+ * \return
+ *      Relative humidity in % as unsigned 22.10 fixed-point
+ */
+uint32_t bmx280CompensateH(const BMX280_Calib_t *calib, int32_t adc_H, int32_t t_fine)
+{
+    int32_t v_x1_u32r;
+
+    v_x1_u32r = (t_fine - ((int32_t)76800));
+
+    v_x1_u32r = ((((adc_H << 14) - (((int32_t)calib->dig_H4) << 20) -
+                   (((int32_t)calib->dig_H5) * v_x1_u32r)) + ((int32_t)16384)) >> 15) *
+                (((((((v_x1_u32r *
+                       ((int32_t)calib->dig_H6)) >> 10) *
+                     (((v_x1_u32r *
+                        ((int32_t)calib->dig_H3)) >> 11) + ((int32_t)32768))) >> 10) + ((int32_t)2097152)) *
+                  ((int32_t)calib->dig_H2) + 8192) >> 14);
+
+    v_x1_u32r = (v_x1_u32r - (((((v_x1_u32r >> 15) * (v_x1_u32r >> 15)) >> 7) *
+                               ((int32_t)calib->dig_H1)) >> 4));
+
+    v_x1_u32r = (v_x1_u32r < 0) ? 0 : v_x1_u32r;
+    v_x1_u32r = (v_x1_u32r > 419430400) ? 419430400 : v_x1_u32r;
+
+    return (uint32_t)(v_x1_u32r >> 12);
+}
+
+/*!
+ * \brief Compensate humidity with architecture specific multiplications (BME280 only)
+ * \details
+ *      Bit-exact with bmx280CompensateH().
+ * \param calib
+ *      Compensation coefficients
+ * \param adc_H
+ *      16-bit uncompensated humidity
+ * \param t_fine
+ *      Fine temperature from bmx280CompensateT()
+ * \return
+ *      Relative humidity in % as unsigned 22.10 fixed-point
+ */
+uint32_t bmx280CompensateHFast(const BMX280_Calib_t *calib, int32_t adc_H, int32_t t_fine)
+{
+    int32_t v_x1_u32r;
+
+    v_x1_u32r = (t_fine - ((int32_t)76800));
+
+    v_x1_u32r = ((((adc_H << 14) - (((int32_t)calib->dig_H4) << 20) -
+                   bmx280MulS32S16(v_x1_u32r, calib->dig_H5)) + ((int32_t)16384)) >> 15) *
+                ((((((bmx280MulS32S16(v_x1_u32r, calib->dig_H6) >> 10) *
+                    ((bmx280MulS32S16(v_x1_u32r, calib->dig_H3) >> 11) + ((int32_t)32768))) >> 10) +
+                  ((int32_t)2097152)) * ((int32_t)calib->dig_H2) + 8192) >> 14);
+
+    v_x1_u32r = (v_x1_u32r - (bmx280MulS32S16(bmx280SqrS32(v_x1_u32r >> 15) >> 7,
+                                              calib->dig_H1) >> 4));
+
+    v_x1_u32r = bmx280ClampHumidity(v_x1_u32r);
+
+    return (uint32_t)(v_x1_u32r >> 12);
+}
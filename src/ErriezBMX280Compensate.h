@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Compensate.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Integer compensation formulas, see datasheet 4.2.3 Compensation formulas
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_COMPENSATE_H_
+#define ERRIEZ_BMX280_COMPENSATE_H_
+
+#include <stdint.h>
+
+/*!
+ * \brief Compensation coefficients, see datasheet 4.2.2 Trimming parameter readout
+ */
+typedef struct {
+    uint16_t dig_T1;    //!< Temperature coefficient T1
+    int16_t dig_T2;     //!< Temperature coefficient T2
+    int16_t dig_T3;     //!< Temperature coefficient T3
+
+    uint16_t dig_P1;    //!< Pressure coefficient P1
+    int16_t dig_P2;     //!< Pressure coefficient P2
+    int16_t dig_P3;     //!< Pressure coefficient P3
+    int16_t dig_P4;     //!< Pressure coefficient P4
+    int16_t dig_P5;     //!< Pressure coefficient P5
+    int16_t dig_P6;     //!< Pressure coefficient P6
+    int16_t dig_P7;     //!< Pressure coefficient P7
+    int16_t dig_P8;     //!< Pressure coefficient P8
+    int16_t dig_P9;     //!< Pressure coefficient P9
+
+    uint8_t dig_H1;     //!< Humidity coefficient H1 (BME280)
+    int16_t dig_H2;     //!< Humidity coefficient H2 (BME280)
+    uint8_t dig_H3;     //!< Humidity coefficient H3 (BME280)
+    int16_t dig_H4;     //!< Humidity coefficient H4 (BME280)
+    int16_t dig_H5;     //!< Humidity coefficient H5 (BME280)
+    int8_t dig_H6;      //!< Humidity coefficient H6 (BME280)
+} BMX280_Calib_t;
+
+/*!
+ * \brief Uncompensated ADC values of one burst read
+ */
+typedef struct {
+    int32_t adc_T;      //!< 20-bit temperature
+    int32_t adc_P;      //!< 20-bit pressure
+    int32_t adc_H;      //!< 16-bit humidity (BME280)
+} BMX280_Raw_t;
+
+/*!
+ * \brief Pressure compensation terms which depend on t_fine only
+ * \details
+ *      Holds the 64-bit divisor of the pressure formula as normalized 32-bit divisor and
+ *      reciprocal, so the division is replaced by multiplications until t_fine changes.
+ */
+typedef struct {
+    int64_t var1;           //!< Divisor
+    int64_t var2;           //!< Offset
+    int32_t t_fine;         //!< Fine temperature of the cached terms
+    uint32_t divisor;       //!< var1 << shift, most significant bit set
+    uint32_t reciprocal;    //!< floor((2^64 - 1) / divisor) - 2^32
+    uint8_t shift;          //!< Normalization shift of var1
+    uint8_t flags;          //!< Cache state
+} BMX280_PressureCache_t;
+
+// Compensation kernels, datasheet reference
+int32_t bmx280CompensateT(const BMX280_Calib_t *calib, int32_t adc_T, int32_t *t_fine);
+uint32_t bmx280CompensateP(const BMX280_Calib_t *calib, int32_t adc_P, int32_t t_fine);
+uint32_t bmx280CompensateH(const BMX280_Calib_t *calib, int32_t adc_H, int32_t t_fine);
+
+// Compensation kernels, optimized and bit-exact with the reference
+int32_t bmx280CompensateTFast(const BMX280_Calib_t *calib, int32_t adc_T, int32_t *t_fine);
+uint32_t bmx280CompensatePCached(const BMX280_Calib_t *calib, BMX280_PressureCache_t *cache,
+                                 int32_t adc_P, int32_t t_fine);
+uint32_t bmx280CompensateHFast(const BMX280_Calib_t *calib, int32_t adc_H, int32_t t_fine);
+void bmx280PressureCacheReset(BMX280_PressureCache_t *cache);
+
+#endif // ERRIEZ_BMX280_COMPENSATE_H_
@@ -0,0 +1,161 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Decimator.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Multi-stage integer decimation of one sample stream into several output rates
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280Decimator.h"
+
+/*!
+ * \brief Constructor
+ * \param stages
+ *      Stage storage
+ * \param numStages
+ *      Number of stages, maximum 8
+ */
+ErriezBMX280Decimator::ErriezBMX280Decimator(BMX280_DecimatorStage_t *stages, uint8_t numStages) :
+    _stages(stages), _numStages(numStages > 8 ? 8 : numStages), _calib(NULL), _humidity(false)
+{
+    for (uint8_t i = 0; i < _numStages; i++) {
+        _stages[i].factor = 1;
+    }
+    reset();
+}
+
+/*!
+ * \brief Set decimation factor of a stage
+ * \param stage
+ *      Stage index
+ * \param factor
+ *      Number of inputs per output, 1..BMX280_DECIMATOR_MAX_FACTOR
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Invalid stage or factor
+ */
+bool ErriezBMX280Decimator::setFactor(uint8_t stage, uint16_t factor)
+{
+    if ((stage >= _numStages) || (factor == 0) || (factor > BMX280_DECIMATOR_MAX_FACTOR)) {
+        return false;
+    }
+
+    _stages[stage].factor = factor;
+    _stages[stage].sumT = 0;
+    _stages[stage].sumP = 0;
+    _stages[stage].sumH = 0;
+    _stages[stage].count = 0;
+
+    return true;
+}
+
+/*!
+ * \brief Clear accumulators and outputs of all stages
+ */
+void ErriezBMX280Decimator::reset()
+{
+    for (uint8_t i = 0; i < _numStages; i++) {
+        _stages[i].sumT = 0;
+        _stages[i].sumP = 0;
+        _stages[i].sumH = 0;
+        _stages[i].count = 0;
+        _stages[i].output.adc_T = 0;
+        _stages[i].output.adc_P = 0;
+        _stages[i].output.adc_H = 0;
+        _stages[i].hasOutput = false;
+    }
+}
+
+/*!
+ * \brief Add input sample
+ * \param sample
+ *      Sample at the input rate, invalid samples are ignored
+ * \return
+ *      Bit mask of stages with a new output
+ */
+uint8_t ErriezBMX280Decimator::add(const ErriezBMX280Sample &sample)
+{
+    BMX280_Raw_t in;
+    uint8_t outputs = 0;
+
+    if (!sample.isValid()) {
+        return 0;
+    }
+
+    _calib = sample.getCalib();
+    _humidity = sample.hasHumidity();
+    in = sample.getRaw();
+
+    for (uint8_t i = 0; i < _numStages; i++) {
+        BMX280_DecimatorStage_t *s = &_stages[i];
+        uint16_t half = s->factor / 2;
+
+        s->sumT += in.adc_T;
+        s->sumP += in.adc_P;
+        s->sumH += in.adc_H;
+
+        if (++s->count < s->factor) {
+            break;
+        }
+
+        // Rounded average is the output of this stage and the input of the next stage
+        s->output.adc_T = (s->sumT + half) / s->factor;
+        s->output.adc_P = (s->sumP + half) / s->factor;
+        s->output.adc_H = (s->sumH + half) / s->factor;
+        s->sumT = 0;
+        s->sumP = 0;
+        s->sumH = 0;
+        s->count = 0;
+        s->hasOutput = true;
+
+        outputs |= (1 << i);
+        in = s->output;
+    }
+
+    return outputs;
+}
+
+/*!
+ * \brief Get last output of a stage
+ * \details
+ *      Compensation of the averaged raw values is done on access of the sample.
+ * \param stage
+ *      Stage index
+ * \return
+ *      Sample, invalid when the stage has no output yet or invalid stage
+ */
+ErriezBMX280Sample ErriezBMX280Decimator::getOutput(uint8_t stage)
+{
+    if ((stage >= _numStages) || !_stages[stage].hasOutput || (_calib == NULL)) {
+        return ErriezBMX280Sample();
+    }
+
+    return ErriezBMX280Sample(_calib, _stages[stage].output, _humidity);
+}
@@ -0,0 +1,93 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Decimator.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Multi-stage integer decimation of one sample stream into several output rates
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_DECIMATOR_H_
+#define ERRIEZ_BMX280_DECIMATOR_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Sample.h"
+
+/*!
+ * \brief Maximum decimation factor of one stage, limited by 32-bit accumulators
+ */
+#define BMX280_DECIMATOR_MAX_FACTOR     4096
+
+/*!
+ * \brief Decimator stage
+ * \details
+ *      Storage is provided by the application, fields are managed by the decimator.
+ */
+typedef struct {
+    uint32_t sumT;              //!< Temperature accumulator
+    uint32_t sumP;              //!< Pressure accumulator
+    uint32_t sumH;              //!< Humidity accumulator
+    BMX280_Raw_t output;        //!< Last output
+    uint16_t factor;            //!< Decimation factor relative to the previous stage
+    uint16_t count;             //!< Number of accumulated inputs
+    bool hasOutput;             //!< Output produced since reset
+} BMX280_DecimatorStage_t;
+
+/*!
+ * \brief BMX280 decimator class
+ * \details
+ *      Cascaded boxcar averages on raw ADC values. The output of stage n is the input
+ *      of stage n+1, so each stage produces a lower output rate from the same stream.
+ *      Cost per input sample is one accumulation, outputs are compensated only when
+ *      accessed.
+ */
+class ErriezBMX280Decimator
+{
+public:
+    // Constructor
+    ErriezBMX280Decimator(BMX280_DecimatorStage_t *stages, uint8_t numStages);
+
+    // Configuration
+    bool setFactor(uint8_t stage, uint16_t factor);
+    void reset();
+
+    // Input
+    uint8_t add(const ErriezBMX280Sample &sample);
+
+    // Output
+    ErriezBMX280Sample getOutput(uint8_t stage);
+
+private:
+    BMX280_DecimatorStage_t *_stages;   //!< Stage storage
+    uint8_t _numStages;                 //!< Number of stages
+    const BMX280_Calib_t *_calib;       //!< Coefficients of the input samples
+    bool _humidity;                     //!< Input samples hold humidity
+};
+
+#endif // ERRIEZ_BMX280_DECIMATOR_H_
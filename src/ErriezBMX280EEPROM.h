@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280EEPROM.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Sample log storage in the internal EEPROM
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_EEPROM_H_
+#define ERRIEZ_BMX280_EEPROM_H_
+
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#include "ErriezBMX280Storage.h"
+
+/*!
+ * \brief BMX280 EEPROM storage class
+ * \details
+ *      Header only: include this file in the sketch on targets with an EEPROM
+ *      library. ESP8266 and ESP32 emulate EEPROM in flash: call EEPROM.begin(size)
+ *      first, sync() commits the emulation buffer.
+ */
+class ErriezBMX280EEPROM : public ErriezBMX280Storage
+{
+public:
+    /*!
+     * \brief Read bytes
+     * \param addr
+     *      Start address
+     * \param buffer
+     *      Buffer to store bytes
+     * \param len
+     *      Number of bytes
+     * \retval true
+     *      Success
+     */
+    bool read(uint32_t addr, uint8_t *buffer, uint16_t len)
+    {
+        for (uint16_t i = 0; i < len; i++) {
+            buffer[i] = EEPROM.read(addr + i);
+        }
+
+        return true;
+    }
+
+    /*!
+     * \brief Write bytes, unchanged bytes are skipped to save write cycles
+     * \param addr
+     *      Start address
+     * \param buffer
+     *      Bytes to write
+     * \param len
+     *      Number of bytes
+     * \retval true
+     *      Success
+     */
+    bool write(uint32_t addr, const uint8_t *buffer, uint16_t len)
+    {
+        for (uint16_t i = 0; i < len; i++) {
+            if (EEPROM.read(addr + i) != buffer[i]) {
+                EEPROM.write(addr + i, buffer[i]);
+            }
+        }
+
+        return true;
+    }
+
+    /*!
+     * \brief Get EEPROM size
+     * \return
+     *      Size in bytes
+     */
+    uint32_t size()
+    {
+        return EEPROM.length();
+    }
+
+    /*!
+     * \brief Make written bytes persistent
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Commit failed
+     */
+    bool sync()
+    {
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+        return EEPROM.commit();
+#else
+        return true;
+#endif
+    }
+};
+
+#endif // ERRIEZ_BMX280_EEPROM_H_
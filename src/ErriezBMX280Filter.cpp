@@ -0,0 +1,147 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Filter.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Software IIR filter on raw ADC values
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280Filter.h"
+
+/*!
+ * \brief Constructor
+ * \param shift
+ *      Filter coefficient 1/2^shift, 0..BMX280_FILTER_MAX_SHIFT
+ */
+ErriezBMX280Filter::ErriezBMX280Filter(uint8_t shift) : _calib(NULL), _humidity(false)
+{
+    setShift(shift);
+}
+
+/*!
+ * \brief Set filter coefficient, resets the filter
+ * \param shift
+ *      Filter coefficient 1/2^shift, 0..BMX280_FILTER_MAX_SHIFT
+ */
+void ErriezBMX280Filter::setShift(uint8_t shift)
+{
+    _shift = (shift > BMX280_FILTER_MAX_SHIFT) ? BMX280_FILTER_MAX_SHIFT : shift;
+    reset();
+}
+
+/*!
+ * \brief Reset filter, the next input sample seeds the state
+ */
+void ErriezBMX280Filter::reset()
+{
+    _accT = 0;
+    _accP = 0;
+    _accH = 0;
+    _seeded = false;
+}
+
+/*!
+ * \brief Set filter state to a sample
+ * \param sample
+ *      Sample, invalid samples are ignored
+ */
+void ErriezBMX280Filter::seed(const ErriezBMX280Sample &sample)
+{
+    const BMX280_Raw_t &raw = sample.getRaw();
+
+    if (!sample.isValid()) {
+        return;
+    }
+
+    _calib = sample.getCalib();
+    _humidity = sample.hasHumidity();
+    _accT = raw.adc_T << _shift;
+    _accP = raw.adc_P << _shift;
+    _accH = raw.adc_H << _shift;
+    _seeded = true;
+}
+
+/*!
+ * \brief Add input sample
+ * \param sample
+ *      Sample, invalid samples are ignored
+ * \return
+ *      Filtered sample
+ */
+ErriezBMX280Sample ErriezBMX280Filter::add(const ErriezBMX280Sample &sample)
+{
+    const BMX280_Raw_t &raw = sample.getRaw();
+
+    if (!sample.isValid()) {
+        return getOutput();
+    }
+
+    if (!_seeded) {
+        seed(sample);
+        return getOutput();
+    }
+
+    // acc = y * 2^shift: y += (x - y) / 2^shift
+    _accT += raw.adc_T - (_accT >> _shift);
+    _accP += raw.adc_P - (_accP >> _shift);
+    _accH += raw.adc_H - (_accH >> _shift);
+
+    return getOutput();
+}
+
+/*!
+ * \brief Get filtered sample
+ * \return
+ *      Sample, invalid when the filter holds no value
+ */
+ErriezBMX280Sample ErriezBMX280Filter::getOutput()
+{
+    if (!_seeded) {
+        return ErriezBMX280Sample();
+    }
+
+    return ErriezBMX280Sample(_calib, getRaw(), _humidity);
+}
+
+/*!
+ * \brief Get filter state
+ * \return
+ *      Filtered raw ADC values, rounded
+ */
+BMX280_Raw_t ErriezBMX280Filter::getRaw()
+{
+    BMX280_Raw_t raw;
+    int32_t half = (1L << _shift) >> 1;
+
+    raw.adc_T = (_accT + half) >> _shift;
+    raw.adc_P = (_accP + half) >> _shift;
+    raw.adc_H = (_accH + half) >> _shift;
+
+    return raw;
+}
@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Filter.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Software IIR filter on raw ADC values
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_FILTER_H_
+#define ERRIEZ_BMX280_FILTER_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Sample.h"
+
+/*!
+ * \brief Maximum filter shift: coefficient 1/1024
+ */
+#define BMX280_FILTER_MAX_SHIFT     10
+
+/*!
+ * \brief BMX280 software filter class
+ * \details
+ *      Integer exponential filter y += (x - y) / 2^shift on raw ADC values, as the
+ *      hardware filter of datasheet 3.4.4 IIR filter, but with coefficients up to
+ *      1/1024 and a state which can be reset, seeded and read. Compensation runs
+ *      once on access of the filtered sample.
+ */
+class ErriezBMX280Filter
+{
+public:
+    // Constructor
+    ErriezBMX280Filter(uint8_t shift = 4);
+
+    // Configuration
+    void setShift(uint8_t shift);
+    void reset();
+    void seed(const ErriezBMX280Sample &sample);
+
+    // Filter
+    ErriezBMX280Sample add(const ErriezBMX280Sample &sample);
+    ErriezBMX280Sample getOutput();
+    BMX280_Raw_t getRaw();
+
+private:
+    int32_t _accT;                  //!< Temperature state * 2^shift
+    int32_t _accP;                  //!< Pressure state * 2^shift
+    int32_t _accH;                  //!< Humidity state * 2^shift
+    const BMX280_Calib_t *_calib;   //!< Coefficients of the input samples
+    uint8_t _shift;                 //!< Coefficient 1/2^shift
+    bool _humidity;                 //!< Input samples hold humidity
+    bool _seeded;                   //!< State holds a value
+};
+
+#endif // ERRIEZ_BMX280_FILTER_H_
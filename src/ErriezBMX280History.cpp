@@ -0,0 +1,217 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280History.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Ring buffer of the last raw samples of a sensor with statistics
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280History.h"
+
+/*!
+ * \brief Constructor
+ * \param entries
+ *      Entry storage
+ * \param size
+ *      Number of entries in storage
+ */
+ErriezBMX280History::ErriezBMX280History(BMX280_HistoryEntry_t *entries, uint16_t size) :
+    _entries(entries), _size(size), _head(0), _count(0), _calib(NULL), _humidity(false)
+{
+
+}
+
+/*!
+ * \brief Remove all samples
+ */
+void ErriezBMX280History::clear()
+{
+    _head = 0;
+    _count = 0;
+}
+
+/*!
+ * \brief Add sample, overwrites the oldest sample when full
+ * \details
+ *      Invalid samples are ignored. All samples must be read from the same sensor.
+ * \param sample
+ *      Sample
+ */
+void ErriezBMX280History::add(const ErriezBMX280Sample &sample)
+{
+    if (!sample.isValid() || (_size == 0)) {
+        return;
+    }
+
+    _calib = sample.getCalib();
+    _humidity = sample.hasHumidity();
+
+    _entries[_head].timestamp = millis();
+    _entries[_head].raw = sample.getRaw();
+
+    if (++_head >= _size) {
+        _head = 0;
+    }
+    if (_count < _size) {
+        _count++;
+    }
+}
+
+/*!
+ * \brief Get number of stored samples
+ * \return
+ *      Number of samples
+ */
+uint16_t ErriezBMX280History::count()
+{
+    return _count;
+}
+
+/*!
+ * \brief Get latest sample
+ * \return
+ *      Sample, invalid when empty
+ */
+ErriezBMX280Sample ErriezBMX280History::getLatest()
+{
+    return get(0);
+}
+
+/*!
+ * \brief Get sample
+ * \param age
+ *      0 = latest, count() - 1 = oldest
+ * \return
+ *      Sample, invalid when age is out of range
+ */
+ErriezBMX280Sample ErriezBMX280History::get(uint16_t age)
+{
+    if (age >= _count) {
+        return ErriezBMX280Sample();
+    }
+
+    return ErriezBMX280Sample(_calib, _entries[index(age)].raw, _humidity);
+}
+
+/*!
+ * \brief Get time a sample was added
+ * \param age
+ *      0 = latest, count() - 1 = oldest
+ * \return
+ *      millis() when added, 0 when age is out of range
+ */
+uint32_t ErriezBMX280History::getTimestamp(uint16_t age)
+{
+    if (age >= _count) {
+        return 0;
+    }
+
+    return _entries[index(age)].timestamp;
+}
+
+/*!
+ * \brief Calculate minimum, maximum and mean of the latest samples
+ * \param n
+ *      Number of latest samples, limited to count()
+ * \param stats
+ *      Statistics
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: No samples
+ */
+bool ErriezBMX280History::getStats(uint16_t n, BMX280_HistoryStats_t *stats)
+{
+    BMX280_PressureCache_t pressCache;
+    int64_t sumT = 0;
+    uint64_t sumP = 0;
+    uint64_t sumH = 0;
+
+    if (n > _count) {
+        n = _count;
+    }
+    if (n == 0) {
+        return false;
+    }
+
+    memset(stats, 0, sizeof(BMX280_HistoryStats_t));
+    stats->count = n;
+
+    // Successive samples mostly share t_fine: cache the pressure terms
+    bmx280PressureCacheReset(&pressCache);
+
+    for (uint16_t age = 0; age < n; age++) {
+        ErriezBMX280Sample sample(_calib, _entries[index(age)].raw, _humidity, &pressCache);
+        int32_t t = sample.getTemperatureNative();
+        uint32_t p = sample.getPressureNative();
+        uint32_t h = _humidity ? sample.getHumidityNative() : 0;
+
+        if ((age == 0) || (t < stats->minTemperature)) {
+            stats->minTemperature = t;
+        }
+        if ((age == 0) || (t > stats->maxTemperature)) {
+            stats->maxTemperature = t;
+        }
+        if ((age == 0) || (p < stats->minPressure)) {
+            stats->minPressure = p;
+        }
+        if ((age == 0) || (p > stats->maxPressure)) {
+            stats->maxPressure = p;
+        }
+        if ((age == 0) || (h < stats->minHumidity)) {
+            stats->minHumidity = h;
+        }
+        if ((age == 0) || (h > stats->maxHumidity)) {
+            stats->maxHumidity = h;
+        }
+
+        sumT += t;
+        sumP += p;
+        sumH += h;
+    }
+
+    stats->meanTemperature = (int32_t)(sumT / n);
+    stats->meanPressure = (uint32_t)(sumP / n);
+    stats->meanHumidity = (uint32_t)(sumH / n);
+
+    return true;
+}
+
+/*!
+ * \brief Get storage index of a sample
+ * \param age
+ *      0 = latest
+ * \return
+ *      Index in entry storage
+ */
+uint16_t ErriezBMX280History::index(uint16_t age)
+{
+    return (_head + _size - 1 - age) % _size;
+}
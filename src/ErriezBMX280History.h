@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280History.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Ring buffer of the last raw samples of a sensor with statistics
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_HISTORY_H_
+#define ERRIEZ_BMX280_HISTORY_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Sample.h"
+
+/*!
+ * \brief History entry
+ */
+typedef struct {
+    uint32_t timestamp;         //!< millis() when added
+    BMX280_Raw_t raw;           //!< Uncompensated burst
+} BMX280_HistoryEntry_t;
+
+/*!
+ * \brief History statistics in native fixed-point units
+ */
+typedef struct {
+    uint16_t count;             //!< Number of samples
+    int32_t minTemperature;     //!< Temperature 0.01 degree Celsius
+    int32_t maxTemperature;     //!< Temperature 0.01 degree Celsius
+    int32_t meanTemperature;    //!< Temperature 0.01 degree Celsius
+    uint32_t minPressure;       //!< Pressure Pa 24.8
+    uint32_t maxPressure;       //!< Pressure Pa 24.8
+    uint32_t meanPressure;      //!< Pressure Pa 24.8
+    uint32_t minHumidity;       //!< Humidity % 22.10, 0 without humidity
+    uint32_t maxHumidity;       //!< Humidity % 22.10, 0 without humidity
+    uint32_t meanHumidity;      //!< Humidity % 22.10, 0 without humidity
+} BMX280_HistoryStats_t;
+
+/*!
+ * \brief BMX280 history class
+ * \details
+ *      Keeps the last raw samples of one sensor in storage provided by the
+ *      application, the oldest sample is overwritten when full. Queries are served
+ *      from RAM without bus access, samples are compensated on access.
+ */
+class ErriezBMX280History
+{
+public:
+    // Constructor
+    ErriezBMX280History(BMX280_HistoryEntry_t *entries, uint16_t size);
+
+    // Store
+    void clear();
+    void add(const ErriezBMX280Sample &sample);
+
+    // Query, age 0 = latest
+    uint16_t count();
+    ErriezBMX280Sample getLatest();
+    ErriezBMX280Sample get(uint16_t age);
+    uint32_t getTimestamp(uint16_t age);
+    bool getStats(uint16_t n, BMX280_HistoryStats_t *stats);
+
+private:
+    BMX280_HistoryEntry_t *_entries;    //!< Entry storage
+    uint16_t _size;                     //!< Number of entries in storage
+    uint16_t _head;                     //!< Index of the next entry
+    uint16_t _count;                    //!< Number of stored entries
+    const BMX280_Calib_t *_calib;       //!< Coefficients of the samples
+    bool _humidity;                     //!< Samples hold humidity
+
+    uint16_t index(uint16_t age);
+};
+
+#endif // ERRIEZ_BMX280_HISTORY_H_
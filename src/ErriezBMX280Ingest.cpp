@@ -0,0 +1,477 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Ingest.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Gateway ingest of log records received from sensor nodes
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280Ingest.h"
+
+/*!
+ * \brief Fill a frame
+ * \param frame
+ *      Frame
+ * \param node
+ *      Node ID
+ * \param record
+ *      Log record of the node
+ */
+void bmx280IngestFramePack(BMX280_IngestFrame_t *frame, uint16_t node,
+                           const BMX280_LogRecord_t *record)
+{
+    frame->record = *record;
+    frame->node = node;
+    frame->crc = bmx280Crc16((const uint8_t *)frame, BMX280_INGEST_FRAME_LEN - 2);
+}
+
+/*!
+ * \brief Check CRC of a frame and its record
+ * \param frame
+ *      Frame
+ * \retval true
+ *      Frame complete
+ * \retval false
+ *      Frame damaged
+ */
+bool bmx280IngestFrameValid(const BMX280_IngestFrame_t *frame)
+{
+    return (frame->crc == bmx280Crc16((const uint8_t *)frame, BMX280_INGEST_FRAME_LEN - 2)) &&
+           bmx280LogRecordValid(&frame->record);
+}
+
+/*!
+ * \brief Constructor
+ * \param slots
+ *      Frame slots
+ * \param numSlots
+ *      Number of slots, numSlots - 1 frames can be queued
+ */
+ErriezBMX280FrameQueue::ErriezBMX280FrameQueue(BMX280_IngestFrame_t *slots,
+                                               BMX280_QueueIndex_t numSlots) :
+    _slots(slots), _numSlots(numSlots), _head(0), _tail(0), _dropped(0)
+{
+
+}
+
+/*!
+ * \brief Get free slot to receive a frame in, producer only
+ * \return
+ *      Slot, NULL when the queue is full: the frame is dropped
+ */
+BMX280_IngestFrame_t *ErriezBMX280FrameQueue::reserve()
+{
+    BMX280_QueueIndex_t head = _head;
+
+    if (next(head) == _tail) {
+        _dropped++;
+        return NULL;
+    }
+
+    return &_slots[head];
+}
+
+/*!
+ * \brief Pass the frame in the reserved slot to the consumer, producer only
+ */
+void ErriezBMX280FrameQueue::commit()
+{
+    // Frame bytes must be visible before the new head
+    BMX280_INGEST_BARRIER();
+    _head = next(_head);
+}
+
+/*!
+ * \brief Copy a received frame into the queue, producer only
+ * \param data
+ *      Received bytes
+ * \param len
+ *      Number of bytes, frames of other lengths are dropped
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Wrong length or queue full
+ */
+bool ErriezBMX280FrameQueue::push(const uint8_t *data, uint8_t len)
+{
+    BMX280_IngestFrame_t *frame;
+
+    if (len != BMX280_INGEST_FRAME_LEN) {
+        _dropped++;
+        return false;
+    }
+
+    frame = reserve();
+    if (frame == NULL) {
+        return false;
+    }
+    memcpy(frame, data, BMX280_INGEST_FRAME_LEN);
+    commit();
+
+    return true;
+}
+
+/*!
+ * \brief Get number of dropped frames, producer only
+ * \return
+ *      Frames dropped on a full queue or with a wrong length
+ */
+uint32_t ErriezBMX280FrameQueue::getDropped()
+{
+    return _dropped;
+}
+
+/*!
+ * \brief Get oldest frame, consumer only
+ * \return
+ *      Frame, valid until release(), NULL when the queue is empty
+ */
+BMX280_IngestFrame_t *ErriezBMX280FrameQueue::front()
+{
+    BMX280_QueueIndex_t tail = _tail;
+
+    if (tail == _head) {
+        return NULL;
+    }
+    // Frame bytes must be read after the head
+    BMX280_INGEST_BARRIER();
+
+    return &_slots[tail];
+}
+
+/*!
+ * \brief Return the slot of the oldest frame to the producer, consumer only
+ */
+void ErriezBMX280FrameQueue::release()
+{
+    // Frame bytes must be read before the slot is reused
+    BMX280_INGEST_BARRIER();
+    _tail = next(_tail);
+}
+
+/*!
+ * \brief Get number of queued frames
+ * \return
+ *      Number of frames
+ */
+BMX280_QueueIndex_t ErriezBMX280FrameQueue::count()
+{
+    BMX280_QueueIndex_t head = _head;
+    BMX280_QueueIndex_t tail = _tail;
+
+    return (head >= tail) ? (head - tail) : (_numSlots - tail + head);
+}
+
+/*!
+ * \brief Get next slot index
+ * \param index
+ *      Slot index
+ * \return
+ *      Following slot index
+ */
+BMX280_QueueIndex_t ErriezBMX280FrameQueue::next(BMX280_QueueIndex_t index)
+{
+    return ((index + 1) >= _numSlots) ? 0 : (index + 1);
+}
+
+/*!
+ * \brief Constructor
+ * \param queue
+ *      Received frames
+ * \param nodes
+ *      Node table
+ * \param maxNodes
+ *      Size of the node table
+ */
+ErriezBMX280Ingest::ErriezBMX280Ingest(ErriezBMX280FrameQueue *queue,
+                                       BMX280_IngestNode_t *nodes, uint16_t maxNodes) :
+    _queue(queue), _nodes(nodes), _maxNodes(maxNodes), _numNodes(0), _callback(NULL)
+{
+    resetStats();
+}
+
+/*!
+ * \brief Add a node
+ * \details
+ *      The table is kept sorted by ID for the lookup of each frame.
+ * \param id
+ *      Node ID
+ * \param calib
+ *      Coefficients of the node, must outlive the ingest
+ * \param archive
+ *      Archive of the node, NULL = samples go to the callback only
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Table full or ID exists
+ */
+bool ErriezBMX280Ingest::addNode(uint16_t id, const BMX280_Calib_t *calib,
+                                 ErriezBMX280Archive *archive)
+{
+    uint16_t i;
+
+    if ((_numNodes >= _maxNodes) || (calib == NULL) || (findNode(id) >= 0)) {
+        return false;
+    }
+
+    for (i = _numNodes; (i > 0) && (_nodes[i - 1].id > id); i--) {
+        _nodes[i] = _nodes[i - 1];
+    }
+    _nodes[i].id = id;
+    _nodes[i].sequence = 0;
+    _nodes[i].window = 0;
+    _nodes[i].calib = calib;
+    _nodes[i].archive = archive;
+    _numNodes++;
+
+    return true;
+}
+
+/*!
+ * \brief Set sample callback
+ * \param callback
+ *      Called for each written sample, NULL = none
+ */
+void ErriezBMX280Ingest::setCallback(BMX280_IngestCallback callback)
+{
+    _callback = callback;
+}
+
+/*!
+ * \brief Process received frames
+ * \param maxFrames
+ *      Maximum number of frames taken from the queue, limits the time per call
+ * \return
+ *      Number of frames taken from the queue
+ */
+uint16_t ErriezBMX280Ingest::process(uint16_t maxFrames)
+{
+    BatchEntry_t batch[BMX280_INGEST_BATCH];
+    uint16_t remaining = maxFrames;
+
+    while ((remaining > 0) && (_queue->front() != NULL)) {
+        writeBatch(batch, decodeBatch(batch, &remaining));
+    }
+
+    return maxFrames - remaining;
+}
+
+/*!
+ * \brief Get counters
+ * \return
+ *      Counters since the last resetStats()
+ */
+const BMX280_IngestStats_t *ErriezBMX280Ingest::getStats()
+{
+    return &_stats;
+}
+
+/*!
+ * \brief Clear counters
+ */
+void ErriezBMX280Ingest::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+/*!
+ * \brief Take frames from the queue and decode the accepted frames
+ * \details
+ *      Frame slots are released right after decoding, so the producer can reuse them
+ *      while the batch is compensated.
+ * \param batch
+ *      Batch of BMX280_INGEST_BATCH entries
+ * \param remaining
+ *      Maximum number of frames taken from the queue, decremented per frame
+ * \return
+ *      Number of accepted frames in the batch
+ */
+uint8_t ErriezBMX280Ingest::decodeBatch(BatchEntry_t *batch, uint16_t *remaining)
+{
+    BMX280_IngestFrame_t *frame;
+    uint8_t n = 0;
+
+    while ((n < BMX280_INGEST_BATCH) && (*remaining > 0) &&
+           ((frame = _queue->front()) != NULL)) {
+        int32_t node;
+
+        (*remaining)--;
+        _stats.frames++;
+
+        if (!bmx280IngestFrameValid(frame)) {
+            _stats.corrupt++;
+        } else if ((node = findNode(frame->node)) < 0) {
+            _stats.unknown++;
+        } else if (acceptFrame(&_nodes[node], &frame->record)) {
+            batch[n].raw = bmx280LogRecordRaw(&frame->record);
+            batch[n].timestamp = frame->record.timestamp;
+            batch[n].node = (uint16_t)node;
+            batch[n].humidity = frame->record.flags & BMX280_LOG_HUMIDITY;
+            n++;
+        }
+
+        _queue->release();
+    }
+
+    return n;
+}
+
+/*!
+ * \brief Compensate a batch and write the samples
+ * \details
+ *      Entries are sorted by node and timestamp: the samples of a node share the
+ *      coefficients and the pressure cache, and frames reordered within the batch are
+ *      archived in time order.
+ * \param batch
+ *      Batch
+ * \param n
+ *      Number of entries
+ */
+void ErriezBMX280Ingest::writeBatch(BatchEntry_t *batch, uint8_t n)
+{
+    BMX280_PressureCache_t pressCache;
+    BMX280_ArchiveSample_t sample;
+    BMX280_IngestNode_t *node = NULL;
+
+    // Insertion sort by node index and timestamp, stable
+    for (uint8_t i = 1; i < n; i++) {
+        BatchEntry_t entry = batch[i];
+        uint8_t j = i;
+
+        while ((j > 0) && ((batch[j - 1].node > entry.node) ||
+                           ((batch[j - 1].node == entry.node) &&
+                            (batch[j - 1].timestamp > entry.timestamp)))) {
+            batch[j] = batch[j - 1];
+            j--;
+        }
+        batch[j] = entry;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        int32_t t_fine;
+
+        if (node != &_nodes[batch[i].node]) {
+            node = &_nodes[batch[i].node];
+            bmx280PressureCacheReset(&pressCache);
+        }
+
+        sample.timestamp = batch[i].timestamp;
+        sample.temperature = bmx280CompensateTFast(node->calib, batch[i].raw.adc_T, &t_fine);
+        sample.pressure = bmx280CompensatePCached(node->calib, &pressCache,
+                                                  batch[i].raw.adc_P, t_fine);
+        sample.humidity = batch[i].humidity ?
+                          bmx280CompensateHFast(node->calib, batch[i].raw.adc_H, t_fine) : 0;
+
+        if ((node->archive != NULL) && !node->archive->append(sample)) {
+            _stats.rejected++;
+            continue;
+        }
+        _stats.written++;
+        if (_callback) {
+            _callback(node->id, sample);
+        }
+    }
+}
+
+/*!
+ * \brief Find node by binary search
+ * \param id
+ *      Node ID
+ * \return
+ *      Index in the node table, -1 = unknown
+ */
+int32_t ErriezBMX280Ingest::findNode(uint16_t id)
+{
+    uint16_t lo = 0;
+    uint16_t hi = _numNodes;
+
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+
+        if (_nodes[mid].id < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return ((lo < _numNodes) && (_nodes[lo].id == id)) ? lo : -1;
+}
+
+/*!
+ * \brief Check and record the sequence number of a frame
+ * \details
+ *      Accepts sequence numbers above the highest received one and unreceived ones of
+ *      the BMX280_INGEST_WINDOW - 1 below it, so reordered frames pass and repeated
+ *      frames are dropped. Frames older than the newest archived sample of the node
+ *      are dropped as late without marking them received: the archive would refuse
+ *      them after the window bit was set.
+ * \param node
+ *      Node
+ * \param record
+ *      Record of the frame
+ * \retval true
+ *      New frame
+ * \retval false
+ *      Duplicate, older than the window or older than the archive
+ */
+bool ErriezBMX280Ingest::acceptFrame(BMX280_IngestNode_t *node, const BMX280_LogRecord_t *record)
+{
+    uint16_t ahead = record->sequence - node->sequence;
+    uint16_t behind = node->sequence - record->sequence;
+    bool newer = (node->window == 0) || ((ahead != 0) && (ahead < 0x8000));
+
+    if (!newer) {
+        if (behind >= BMX280_INGEST_WINDOW) {
+            _stats.late++;
+            return false;
+        }
+        if (node->window & ((uint32_t)1 << behind)) {
+            _stats.duplicates++;
+            return false;
+        }
+    }
+
+    if ((node->archive != NULL) && (record->timestamp < node->archive->getLastTimestamp())) {
+        _stats.late++;
+        return false;
+    }
+
+    if (newer) {
+        // First frame or newer: slide the window
+        node->window = ((node->window == 0) || (ahead >= BMX280_INGEST_WINDOW)) ?
+                       1 : ((node->window << ahead) | 1);
+        node->sequence = record->sequence;
+    } else {
+        node->window |= (uint32_t)1 << behind;
+    }
+
+    return true;
+}
@@ -0,0 +1,195 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Ingest.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Gateway ingest of log records received from sensor nodes
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_INGEST_H_
+#define ERRIEZ_BMX280_INGEST_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Archive.h"
+#include "ErriezBMX280Log.h"
+
+#define BMX280_INGEST_FRAME_LEN     20      //!< Frame length in bytes
+#define BMX280_INGEST_BATCH         16      //!< Frames compensated per batch
+#define BMX280_INGEST_WINDOW        32      //!< Sequence numbers tracked per node
+
+// Queue indices must be read and written in one instruction by producer and consumer
+#if defined(__AVR__)
+typedef uint8_t BMX280_QueueIndex_t;        //!< Queue index, 255 slots maximum
+#define BMX280_INGEST_BARRIER()     __asm__ __volatile__("" ::: "memory")
+#else
+typedef uint16_t BMX280_QueueIndex_t;       //!< Queue index, 65535 slots maximum
+#define BMX280_INGEST_BARRIER()     __sync_synchronize()
+#endif
+
+/*!
+ * \brief Frame sent by a sensor node
+ * \details
+ *      A log record of the node, see ErriezBMX280Log, with the node ID. The record
+ *      keeps its own CRC, the frame CRC covers the node ID as well.
+ */
+typedef struct {
+    BMX280_LogRecord_t record;  //!< Uncompensated sample, timestamp and sequence number
+    uint16_t node;              //!< Node ID
+    uint16_t crc;               //!< CRC-16/CCITT of the previous 18 bytes
+} BMX280_IngestFrame_t;
+
+/*!
+ * \brief Sensor node known by the gateway
+ */
+typedef struct {
+    uint16_t id;                    //!< Node ID
+    uint16_t sequence;              //!< Highest received sequence number
+    uint32_t window;                //!< Bit n: sequence - n received, 0 = none received
+    const BMX280_Calib_t *calib;    //!< Coefficients of the node
+    ErriezBMX280Archive *archive;   //!< Archive of the node, NULL = callback only
+} BMX280_IngestNode_t;
+
+/*!
+ * \brief Ingest counters
+ */
+typedef struct {
+    uint32_t frames;            //!< Frames taken from the queue
+    uint32_t corrupt;           //!< Frames with CRC error
+    uint32_t unknown;           //!< Frames of unknown nodes
+    uint32_t duplicates;        //!< Frames received before
+    uint32_t late;              //!< Frames older than the sequence window or the archive
+    uint32_t written;           //!< Samples written
+    uint32_t rejected;          //!< Samples rejected by the archive
+} BMX280_IngestStats_t;
+
+/*!
+ * \brief Compensated sample callback
+ * \param node
+ *      Node ID
+ * \param sample
+ *      Sample in native fixed-point units
+ */
+typedef void (*BMX280_IngestCallback)(uint16_t node, const BMX280_ArchiveSample_t &sample);
+
+// Frame format
+void bmx280IngestFramePack(BMX280_IngestFrame_t *frame, uint16_t node,
+                           const BMX280_LogRecord_t *record);
+bool bmx280IngestFrameValid(const BMX280_IngestFrame_t *frame);
+
+/*!
+ * \brief BMX280 frame queue class
+ * \details
+ *      Bounded ring of frame slots between one producer, for example a radio interrupt
+ *      or a receive task on another core, and one consumer. The producer writes only
+ *      the head and the consumer only the tail, so no lock is needed. Frames are
+ *      received into and processed from the slots: no copies and no allocations.
+ *      One slot stays free to tell a full queue from an empty queue.
+ */
+class ErriezBMX280FrameQueue
+{
+public:
+    // Constructor
+    ErriezBMX280FrameQueue(BMX280_IngestFrame_t *slots, BMX280_QueueIndex_t numSlots);
+
+    // Producer
+    BMX280_IngestFrame_t *reserve();
+    void commit();
+    bool push(const uint8_t *data, uint8_t len);
+    uint32_t getDropped();
+
+    // Consumer
+    BMX280_IngestFrame_t *front();
+    void release();
+    BMX280_QueueIndex_t count();
+
+private:
+    BMX280_IngestFrame_t *_slots;       //!< Frame slots
+    BMX280_QueueIndex_t _numSlots;      //!< Number of slots
+    volatile BMX280_QueueIndex_t _head; //!< Next slot to fill, written by producer
+    volatile BMX280_QueueIndex_t _tail; //!< Next slot to process, written by consumer
+    uint32_t _dropped;                  //!< Frames dropped on a full queue, producer
+
+    BMX280_QueueIndex_t next(BMX280_QueueIndex_t index);
+};
+
+/*!
+ * \brief BMX280 ingest class
+ * \details
+ *      Takes frames from a queue in batches of BMX280_INGEST_BATCH: checks the CRC,
+ *      looks up the node by binary search in the node table, drops duplicates with a
+ *      sliding window of sequence numbers and frames older than the archive of the
+ *      node, compensates the batch grouped by node and
+ *      writes the samples to the archive of the node and the callback. The node table
+ *      is provided by the application, the pipeline does not allocate memory.
+ */
+class ErriezBMX280Ingest
+{
+public:
+    // Constructor
+    ErriezBMX280Ingest(ErriezBMX280FrameQueue *queue, BMX280_IngestNode_t *nodes,
+                       uint16_t maxNodes);
+
+    // Configuration
+    bool addNode(uint16_t id, const BMX280_Calib_t *calib, ErriezBMX280Archive *archive = NULL);
+    void setCallback(BMX280_IngestCallback callback);
+
+    // Call from loop()
+    uint16_t process(uint16_t maxFrames = BMX280_INGEST_BATCH);
+
+    // Statistics
+    const BMX280_IngestStats_t *getStats();
+    void resetStats();
+
+private:
+    /*!
+     * \brief Decoded frame of a batch
+     */
+    typedef struct {
+        BMX280_Raw_t raw;       //!< Uncompensated sample
+        uint32_t timestamp;     //!< Application time of the node
+        uint16_t node;          //!< Index in the node table
+        bool humidity;          //!< adc_H valid
+    } BatchEntry_t;
+
+    ErriezBMX280FrameQueue *_queue;     //!< Received frames
+    BMX280_IngestNode_t *_nodes;        //!< Node table, sorted by ID
+    uint16_t _maxNodes;                 //!< Size of the node table
+    uint16_t _numNodes;                 //!< Number of nodes
+    BMX280_IngestCallback _callback;    //!< Sample callback, NULL = none
+    BMX280_IngestStats_t _stats;        //!< Counters
+
+    uint8_t decodeBatch(BatchEntry_t *batch, uint16_t *remaining);
+    void writeBatch(BatchEntry_t *batch, uint8_t n);
+    int32_t findNode(uint16_t id);
+    bool acceptFrame(BMX280_IngestNode_t *node, const BMX280_LogRecord_t *record);
+};
+
+#endif // ERRIEZ_BMX280_INGEST_H_
@@ -0,0 +1,210 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Kernels.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Architecture specific multiplications for the compensation kernels
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_KERNELS_H_
+#define ERRIEZ_BMX280_KERNELS_H_
+
+#include <stdint.h>
+
+#if defined(__AVR__)
+
+// AVR: the MUL instruction is 8x8 bits. avr-gcc builds 16x16->32 and 32x32->64 widening
+// multiplications from it, but calls the generic 64x64 multiplication for int64_t
+// operands. The compensation operands are much narrower than their types: narrow them
+// when the value allows, results are identical to the generic versions.
+
+/*!
+ * \brief Multiply 32-bit by 16-bit, 32-bit result
+ */
+static inline int32_t bmx280MulS32S16(int32_t a, int16_t b)
+{
+    if (a == (int16_t)a) {
+        return (int32_t)(int16_t)a * b;
+    }
+    return a * (int32_t)b;
+}
+
+/*!
+ * \brief Square 32-bit, 32-bit result
+ */
+static inline int32_t bmx280SqrS32(int32_t a)
+{
+    if (a == (int16_t)a) {
+        return (int32_t)(int16_t)a * (int16_t)a;
+    }
+    return a * a;
+}
+
+/*!
+ * \brief Square 64-bit, 64-bit result
+ */
+static inline int64_t bmx280SqrS64(int64_t a)
+{
+    if (a == (int32_t)a) {
+        return (int64_t)(int32_t)a * (int32_t)a;
+    }
+    return a * a;
+}
+
+/*!
+ * \brief Multiply 64-bit by 16-bit, 64-bit result
+ */
+static inline int64_t bmx280MulS64S16(int64_t a, int16_t b)
+{
+    uint32_t lo = (uint32_t)a;
+    uint32_t hi = (uint32_t)((uint64_t)a >> 32);
+    uint64_t low;
+
+    // a * b = (hi * b) << 32 + lo * b, modulo 2^64
+    if (b < 0) {
+        low = 0 - ((uint64_t)lo * (uint32_t)(0 - (int32_t)b));
+    } else {
+        low = (uint64_t)lo * (uint32_t)b;
+    }
+
+    return (int64_t)(((uint64_t)(hi * (uint32_t)(int32_t)b) << 32) + low);
+}
+
+/*!
+ * \brief Clamp humidity to 0..100 %RH in Q22.10 << 12
+ */
+static inline int32_t bmx280ClampHumidity(int32_t v)
+{
+    v = (v < 0) ? 0 : v;
+    return (v > 419430400) ? 419430400 : v;
+}
+
+#elif defined(__ARM_FEATURE_DSP)
+
+// Cortex-M4/M7: 32x32 multiplications are single cycle, SMULL produces a 64-bit result
+// in one instruction and USAT saturates in one instruction. A 64x64 multiplication
+// needs UMULL plus two MLA. Narrow 64-bit operands to 32-bit when the value allows, so
+// the compiler selects SMULL, results are identical to the generic versions.
+
+/*!
+ * \brief Multiply 32-bit by 16-bit, 32-bit result
+ */
+static inline int32_t bmx280MulS32S16(int32_t a, int16_t b)
+{
+    return a * (int32_t)b;
+}
+
+/*!
+ * \brief Square 32-bit, 32-bit result
+ */
+static inline int32_t bmx280SqrS32(int32_t a)
+{
+    return a * a;
+}
+
+/*!
+ * \brief Square 64-bit, 64-bit result
+ */
+static inline int64_t bmx280SqrS64(int64_t a)
+{
+    if (a == (int32_t)a) {
+        return (int64_t)(int32_t)a * (int32_t)a;
+    }
+    return a * a;
+}
+
+/*!
+ * \brief Multiply 64-bit by 16-bit, 64-bit result
+ */
+static inline int64_t bmx280MulS64S16(int64_t a, int16_t b)
+{
+    if (a == (int32_t)a) {
+        return (int64_t)(int32_t)a * b;
+    }
+    return a * (int64_t)b;
+}
+
+/*!
+ * \brief Clamp humidity to 0..100 %RH in Q22.10 << 12
+ */
+static inline int32_t bmx280ClampHumidity(int32_t v)
+{
+    // USAT #31: negative values saturate to 0
+    __asm__ ("usat %0, #31, %1" : "=r" (v) : "r" (v));
+    return (v > 419430400) ? 419430400 : v;
+}
+
+#else
+
+// Generic C: the compiler selects the multiply instructions
+
+/*!
+ * \brief Multiply 32-bit by 16-bit, 32-bit result
+ */
+static inline int32_t bmx280MulS32S16(int32_t a, int16_t b)
+{
+    return a * (int32_t)b;
+}
+
+/*!
+ * \brief Square 32-bit, 32-bit result
+ */
+static inline int32_t bmx280SqrS32(int32_t a)
+{
+    return a * a;
+}
+
+/*!
+ * \brief Square 64-bit, 64-bit result
+ */
+static inline int64_t bmx280SqrS64(int64_t a)
+{
+    return a * a;
+}
+
+/*!
+ * \brief Multiply 64-bit by 16-bit, 64-bit result
+ */
+static inline int64_t bmx280MulS64S16(int64_t a, int16_t b)
+{
+    return a * (int64_t)b;
+}
+
+/*!
+ * \brief Clamp humidity to 0..100 %RH in Q22.10 << 12
+ */
+static inline int32_t bmx280ClampHumidity(int32_t v)
+{
+    v = (v < 0) ? 0 : v;
+    return (v > 419430400) ? 419430400 : v;
+}
+
+#endif
+
+#endif // ERRIEZ_BMX280_KERNELS_H_
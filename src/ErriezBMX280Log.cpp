@@ -0,0 +1,389 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Log.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Raw sample log record format and crash-safe circular log
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280Log.h"
+
+/*!
+ * \brief Calculate CRC-16/CCITT, polynomial 0x1021
+ * \param data
+ *      Bytes
+ * \param len
+ *      Number of bytes
+ * \param crc
+ *      Initial value 0xFFFF, or the CRC of the previous bytes to continue
+ * \return
+ *      CRC
+ */
+uint16_t bmx280Crc16(const uint8_t *data, uint16_t len, uint16_t crc)
+{
+    while (len--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/*!
+ * \brief Fill a log record
+ * \param record
+ *      Record
+ * \param raw
+ *      Uncompensated burst
+ * \param humidity
+ *      adc_H valid
+ * \param timestamp
+ *      Application time
+ * \param sequence
+ *      Sequence number
+ */
+void bmx280LogRecordPack(BMX280_LogRecord_t *record, const BMX280_Raw_t &raw, bool humidity,
+                         uint32_t timestamp, uint16_t sequence)
+{
+    record->timestamp = timestamp;
+    record->sequence = sequence;
+    record->raw[0] = raw.adc_P >> 12;
+    record->raw[1] = raw.adc_P >> 4;
+    record->raw[2] = ((raw.adc_P & 0x0F) << 4) | ((raw.adc_T >> 16) & 0x0F);
+    record->raw[3] = raw.adc_T >> 8;
+    record->raw[4] = raw.adc_T;
+    record->raw[5] = raw.adc_H >> 8;
+    record->raw[6] = raw.adc_H;
+    record->flags = humidity ? BMX280_LOG_HUMIDITY : 0;
+    record->crc = bmx280Crc16((const uint8_t *)record, BMX280_LOG_RECORD_LEN - 2);
+}
+
+/*!
+ * \brief Check CRC of a log record
+ * \param record
+ *      Record
+ * \retval true
+ *      Record complete
+ * \retval false
+ *      Record not written, erased or torn
+ */
+bool bmx280LogRecordValid(const BMX280_LogRecord_t *record)
+{
+    return record->crc == bmx280Crc16((const uint8_t *)record, BMX280_LOG_RECORD_LEN - 2);
+}
+
+/*!
+ * \brief Unpack the raw values of a log record
+ * \param record
+ *      Record
+ * \return
+ *      Uncompensated burst
+ */
+BMX280_Raw_t bmx280LogRecordRaw(const BMX280_LogRecord_t *record)
+{
+    BMX280_Raw_t raw;
+
+    raw.adc_P = ((uint32_t)record->raw[0] << 12) | ((uint32_t)record->raw[1] << 4) |
+                (record->raw[2] >> 4);
+    raw.adc_T = ((uint32_t)(record->raw[2] & 0x0F) << 16) | ((uint32_t)record->raw[3] << 8) |
+                record->raw[4];
+    raw.adc_H = (record->flags & BMX280_LOG_HUMIDITY) ?
+                (((uint16_t)record->raw[5] << 8) | record->raw[6]) : 0;
+
+    return raw;
+}
+
+/*!
+ * \brief Get sample of a log record
+ * \param record
+ *      Record
+ * \param calib
+ *      Coefficients of the sensor which was logged, must outlive the sample
+ * \return
+ *      Sample, compensated on access
+ */
+ErriezBMX280Sample bmx280LogRecordSample(const BMX280_LogRecord_t *record,
+                                         const BMX280_Calib_t *calib)
+{
+    return ErriezBMX280Sample(calib, bmx280LogRecordRaw(record),
+                              record->flags & BMX280_LOG_HUMIDITY);
+}
+
+/*!
+ * \brief Constructor
+ * \param storage
+ *      Storage
+ * \param offset
+ *      Start of the log region in bytes
+ * \param length
+ *      Length of the log region in bytes, 0 = until end of storage
+ */
+ErriezBMX280Log::ErriezBMX280Log(ErriezBMX280Storage *storage, uint32_t offset,
+                                 uint32_t length) :
+    _storage(storage), _offset(offset), _length(length), _capacity(0), _head(0), _count(0),
+    _sequence(0)
+{
+
+}
+
+/*!
+ * \brief Find the newest record after reset or power loss
+ * \details
+ *      Slots before the head hold the sequence numbers of slot 0 plus their index,
+ *      the head is the first slot that breaks this rule: it is unwritten, torn or
+ *      holds an older record. The rule is monotone, so a binary search finds it.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Region smaller than two records
+ */
+bool ErriezBMX280Log::begin()
+{
+    BMX280_LogRecord_t record;
+    uint32_t length = _length;
+    uint16_t first;
+    uint16_t lo;
+    uint16_t hi;
+
+    if (length == 0) {
+        length = _storage->size() - _offset;
+    }
+    _capacity = ((length / BMX280_LOG_RECORD_LEN) > BMX280_LOG_MAX_RECORDS) ?
+                BMX280_LOG_MAX_RECORDS : (length / BMX280_LOG_RECORD_LEN);
+    if (_capacity < 2) {
+        return false;
+    }
+
+    if (!readSlot(0, &record)) {
+        // Empty, or slot 0 torn after a wrap: newest record in the last slot
+        _head = 0;
+        if (readSlot(_capacity - 1, &record)) {
+            _sequence = record.sequence + 1;
+            _count = _capacity - 1;
+        } else {
+            _sequence = 0;
+            _count = 0;
+        }
+        return true;
+    }
+
+    // Binary search for the first slot breaking the sequence of slot 0
+    first = record.sequence;
+    lo = 1;
+    hi = _capacity;
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+
+        if (isSlot(mid, first + mid)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    _head = (lo == _capacity) ? 0 : lo;
+    _sequence = first + lo;
+
+    // Count older records after the head, skipping a torn record at the head
+    if (lo == _capacity) {
+        _count = _capacity;
+    } else if (isSlot(lo, first + lo - _capacity)) {
+        _count = _capacity;
+    } else if (((lo + 1) < _capacity) && isSlot(lo + 1, first + lo + 1 - _capacity)) {
+        _count = _capacity - 1;
+    } else {
+        _count = lo;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Erase all records
+ * \details
+ *      Required once for storage holding other data, which could pass the CRC.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Write failed or region too small
+ */
+bool ErriezBMX280Log::format()
+{
+    uint8_t erased[BMX280_LOG_RECORD_LEN];
+
+    if ((_capacity == 0) && !begin()) {
+        return false;
+    }
+
+    memset(erased, 0xFF, sizeof(erased));
+    for (uint16_t slot = 0; slot < _capacity; slot++) {
+        if (!_storage->write(_offset + (uint32_t)slot * BMX280_LOG_RECORD_LEN,
+                             erased, sizeof(erased))) {
+            return false;
+        }
+    }
+
+    _head = 0;
+    _count = 0;
+    _sequence = 0;
+
+    return _storage->sync();
+}
+
+/*!
+ * \brief Append sample, overwrites the oldest record when full
+ * \details
+ *      Call sync() periodically when the storage has a write cache.
+ * \param sample
+ *      Sample, invalid samples are ignored
+ * \param timestamp
+ *      Application time, for example RTC seconds
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Invalid sample, log not initialized or write failed
+ */
+bool ErriezBMX280Log::append(const ErriezBMX280Sample &sample, uint32_t timestamp)
+{
+    BMX280_LogRecord_t record;
+
+    if (!sample.isValid() || (_capacity == 0)) {
+        return false;
+    }
+
+    bmx280LogRecordPack(&record, sample.getRaw(), sample.hasHumidity(), timestamp, _sequence);
+    if (!_storage->write(_offset + (uint32_t)_head * BMX280_LOG_RECORD_LEN,
+                         (const uint8_t *)&record, BMX280_LOG_RECORD_LEN)) {
+        return false;
+    }
+
+    _sequence++;
+    if (++_head >= _capacity) {
+        _head = 0;
+    }
+    if (_count < _capacity) {
+        _count++;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Make appended records persistent
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Write failed
+ */
+bool ErriezBMX280Log::sync()
+{
+    return _storage->sync();
+}
+
+/*!
+ * \brief Get number of records
+ * \return
+ *      Number of records
+ */
+uint16_t ErriezBMX280Log::count()
+{
+    return _count;
+}
+
+/*!
+ * \brief Get number of record slots
+ * \return
+ *      Maximum number of records, 0 before begin()
+ */
+uint16_t ErriezBMX280Log::capacity()
+{
+    return _capacity;
+}
+
+/*!
+ * \brief Read record
+ * \param age
+ *      0 = newest, count() - 1 = oldest
+ * \param record
+ *      Record
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Age out of range, read failed or record damaged
+ */
+bool ErriezBMX280Log::read(uint16_t age, BMX280_LogRecord_t *record)
+{
+    if (age >= _count) {
+        return false;
+    }
+
+    return readSlot((_head + _capacity - 1 - age) % _capacity, record);
+}
+
+/*!
+ * \brief Read and check a record slot
+ * \param slot
+ *      Slot index
+ * \param record
+ *      Record
+ * \retval true
+ *      Valid record
+ * \retval false
+ *      Read failed or no valid record
+ */
+bool ErriezBMX280Log::readSlot(uint16_t slot, BMX280_LogRecord_t *record)
+{
+    if (!_storage->read(_offset + (uint32_t)slot * BMX280_LOG_RECORD_LEN,
+                        (uint8_t *)record, BMX280_LOG_RECORD_LEN)) {
+        return false;
+    }
+
+    return bmx280LogRecordValid(record);
+}
+
+/*!
+ * \brief Check if a slot holds a valid record with a sequence number
+ * \param slot
+ *      Slot index
+ * \param sequence
+ *      Expected sequence number
+ * \retval true
+ *      Valid record with the sequence number
+ * \retval false
+ *      Other record or no valid record
+ */
+bool ErriezBMX280Log::isSlot(uint16_t slot, uint16_t sequence)
+{
+    BMX280_LogRecord_t record;
+
+    return readSlot(slot, &record) && (record.sequence == sequence);
+}
@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Log.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Raw sample log record format and crash-safe circular log
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_LOG_H_
+#define ERRIEZ_BMX280_LOG_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Sample.h"
+#include "ErriezBMX280Storage.h"
+
+#define BMX280_LOG_RECORD_LEN       16      //!< Record length in bytes
+#define BMX280_LOG_HUMIDITY         0x01    //!< Record flag: adc_H valid
+#define BMX280_LOG_MAX_RECORDS      32767   //!< Maximum records, half the sequence range
+
+/*!
+ * \brief Raw sample log record
+ * \details
+ *      16 bytes without padding, little-endian. The raw values are packed as in the
+ *      data registers: adc_P 20 bits, adc_T 20 bits, adc_H 16 bits. The sequence
+ *      number increments by one per record and wraps.
+ */
+typedef struct {
+    uint32_t timestamp;         //!< Application time, for example RTC seconds
+    uint16_t sequence;          //!< Sequence number
+    uint8_t raw[7];             //!< Packed adc_P, adc_T, adc_H
+    uint8_t flags;              //!< BMX280_LOG_HUMIDITY
+    uint16_t crc;               //!< CRC-16/CCITT of the previous 14 bytes
+} BMX280_LogRecord_t;
+
+// Record format
+void bmx280LogRecordPack(BMX280_LogRecord_t *record, const BMX280_Raw_t &raw, bool humidity,
+                         uint32_t timestamp, uint16_t sequence);
+bool bmx280LogRecordValid(const BMX280_LogRecord_t *record);
+BMX280_Raw_t bmx280LogRecordRaw(const BMX280_LogRecord_t *record);
+ErriezBMX280Sample bmx280LogRecordSample(const BMX280_LogRecord_t *record,
+                                         const BMX280_Calib_t *calib);
+uint16_t bmx280Crc16(const uint8_t *data, uint16_t len, uint16_t crc = 0xFFFF);
+
+/*!
+ * \brief BMX280 circular log class
+ * \details
+ *      Fixed-size ring of records in a storage region, the oldest record is
+ *      overwritten when full. Each append writes one record, nothing else: a record
+ *      torn by power loss fails its CRC and is skipped. begin() finds the newest
+ *      record with a binary search on the sequence numbers in O(log n) reads.
+ */
+class ErriezBMX280Log
+{
+public:
+    // Constructor
+    ErriezBMX280Log(ErriezBMX280Storage *storage, uint32_t offset = 0, uint32_t length = 0);
+
+    // Initialization
+    bool begin();
+    bool format();
+
+    // Store
+    bool append(const ErriezBMX280Sample &sample, uint32_t timestamp);
+    bool sync();
+
+    // Query, age 0 = newest
+    uint16_t count();
+    uint16_t capacity();
+    bool read(uint16_t age, BMX280_LogRecord_t *record);
+
+private:
+    ErriezBMX280Storage *_storage;      //!< Storage
+    uint32_t _offset;                   //!< Start of the log region in bytes
+    uint32_t _length;                   //!< Length of the log region, 0 = until end
+    uint16_t _capacity;                 //!< Number of record slots
+    uint16_t _head;                     //!< Slot of the next record
+    uint16_t _count;                    //!< Number of valid records
+    uint16_t _sequence;                 //!< Sequence number of the next record
+
+    bool readSlot(uint16_t slot, BMX280_LogRecord_t *record);
+    bool isSlot(uint16_t slot, uint16_t sequence);
+};
+
+#endif // ERRIEZ_BMX280_LOG_H_
@@ -0,0 +1,473 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280PageLog.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Wear-leveled page log for flash and page-write EEPROM
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280PageLog.h"
+
+/*!
+ * \brief Constructor
+ * \param storage
+ *      Storage
+ * \param pageBuffer
+ *      Page buffer of pageSize bytes, must outlive the log
+ * \param pageSize
+ *      Page size in bytes, a multiple of 16 of at least 32. Use the flash erase size
+ *      or the EEPROM page write size
+ * \param offset
+ *      Start of the log region in bytes, page aligned for flash
+ * \param length
+ *      Length of the log region in bytes, 0 = until end of storage
+ */
+ErriezBMX280PageLog::ErriezBMX280PageLog(ErriezBMX280Storage *storage, uint8_t *pageBuffer,
+                                         uint16_t pageSize, uint32_t offset, uint32_t length) :
+    _storage(storage), _buffer(pageBuffer), _pageSize(pageSize), _offset(offset),
+    _length(length), _recordsPerPage(0), _pages(0), _head(0), _used(0), _sequence(0),
+    _recordSequence(0), _records(0), _buffered(0), _pageWrites(0)
+{
+    uint16_t records = (pageSize - BMX280_PAGE_HEADER_LEN) / BMX280_LOG_RECORD_LEN;
+
+    if (pageSize >= (BMX280_PAGE_HEADER_LEN + BMX280_LOG_RECORD_LEN)) {
+        _recordsPerPage = (records > BMX280_PAGE_MAX_RECORDS) ? BMX280_PAGE_MAX_RECORDS : records;
+    }
+}
+
+/*!
+ * \brief Find the newest page after reset or power loss
+ * \details
+ *      Pages before the head hold the page sequence number of page 0 plus their
+ *      index, the head is the first page that breaks this rule. The rule is monotone,
+ *      so a binary search finds it. Discards the page buffer.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Invalid page size or region smaller than two pages
+ */
+bool ErriezBMX280PageLog::begin()
+{
+    BMX280_PageHeader_t header;
+    BMX280_LogRecord_t record;
+    uint32_t length = _length;
+    uint32_t first;
+    uint16_t lo;
+    uint16_t hi;
+
+    if (length == 0) {
+        length = _storage->size() - _offset;
+    }
+    _pages = ((length / _pageSize) > 0xFFFF) ? 0xFFFF : (length / _pageSize);
+    if ((_recordsPerPage == 0) || (_pages < 2)) {
+        _pages = 0;
+        return false;
+    }
+
+    _buffered = 0;
+    _pageWrites = 0;
+
+    if (!readPage(0, &header)) {
+        // Empty, or page 0 torn after a wrap: newest page is the last page
+        _head = 0;
+        if (readPage(_pages - 1, &header)) {
+            _sequence = header.sequence + 1;
+            _used = _pages - 1;
+        } else {
+            _sequence = 0;
+            _used = 0;
+        }
+    } else {
+        // Binary search for the first page breaking the sequence of page 0
+        first = header.sequence;
+        lo = 1;
+        hi = _pages;
+        while (lo < hi) {
+            uint16_t mid = lo + (hi - lo) / 2;
+
+            if (isPage(mid, first + mid)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        _head = (lo == _pages) ? 0 : lo;
+        _sequence = first + lo;
+
+        // Count older pages after the head, skipping a torn page at the head
+        if (lo == _pages) {
+            _used = _pages;
+        } else if (isPage(lo, first + lo - _pages)) {
+            _used = _pages;
+        } else if (((lo + 1) < _pages) && isPage(lo + 1, first + lo + 1 - _pages)) {
+            _used = _pages - 1;
+        } else {
+            _used = lo;
+        }
+    }
+
+    // Count records and continue the record sequence of the newest record
+    _records = 0;
+    _recordSequence = 0;
+    for (uint16_t i = 0; i < _used; i++) {
+        if (readHeader((_head + _pages - 1 - i) % _pages, &header)) {
+            _records += header.count;
+        }
+    }
+    if (read(0, &record)) {
+        _recordSequence = record.sequence + 1;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Erase all pages
+ * \details
+ *      Required once for storage holding other data, which could pass the CRC.
+ *      Discards the page buffer.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Erase or write failed, invalid page size or region too small
+ */
+bool ErriezBMX280PageLog::format()
+{
+    uint8_t erased[BMX280_PAGE_HEADER_LEN];
+
+    if ((_pages == 0) && !begin()) {
+        return false;
+    }
+
+    memset(erased, 0xFF, sizeof(erased));
+    for (uint16_t page = 0; page < _pages; page++) {
+        if (!_storage->erase(pageAddress(page), _pageSize) ||
+            !_storage->write(pageAddress(page), erased, sizeof(erased))) {
+            return false;
+        }
+    }
+
+    _head = 0;
+    _used = 0;
+    _sequence = 0;
+    _recordSequence = 0;
+    _records = 0;
+    _buffered = 0;
+
+    return _storage->sync();
+}
+
+/*!
+ * \brief Append sample to the page buffer, writes the page when full
+ * \details
+ *      The oldest page is overwritten when the log is full.
+ * \param sample
+ *      Sample, invalid samples are ignored
+ * \param timestamp
+ *      Application time, for example RTC seconds
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Invalid sample, log not initialized or page write failed. A record
+ *      which was buffered stays in the page buffer for the next write.
+ */
+bool ErriezBMX280PageLog::append(const ErriezBMX280Sample &sample, uint32_t timestamp)
+{
+    BMX280_LogRecord_t record;
+
+    if (!sample.isValid() || (_pages == 0)) {
+        return false;
+    }
+
+    // Retry a failed page write
+    if ((_buffered == _recordsPerPage) && !writePage()) {
+        return false;
+    }
+
+    bmx280LogRecordPack(&record, sample.getRaw(), sample.hasHumidity(), timestamp,
+                        _recordSequence++);
+    memcpy(&_buffer[BMX280_PAGE_HEADER_LEN + _buffered * BMX280_LOG_RECORD_LEN],
+           &record, BMX280_LOG_RECORD_LEN);
+    _buffered++;
+
+    if (_buffered == _recordsPerPage) {
+        return writePage();
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Write a partially filled page buffer
+ * \details
+ *      Call before a planned power down. The records occupy a complete page, so
+ *      frequent flushes reduce the capacity and increase wear.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Page write failed
+ */
+bool ErriezBMX280PageLog::flush()
+{
+    if (_buffered == 0) {
+        return _storage->sync();
+    }
+
+    return writePage();
+}
+
+/*!
+ * \brief Get number of records
+ * \return
+ *      Number of records in storage and page buffer
+ */
+uint32_t ErriezBMX280PageLog::count()
+{
+    return _records + _buffered;
+}
+
+/*!
+ * \brief Get number of records when all pages are full
+ * \return
+ *      Maximum number of records, 0 before begin()
+ */
+uint32_t ErriezBMX280PageLog::capacity()
+{
+    return (uint32_t)_pages * _recordsPerPage;
+}
+
+/*!
+ * \brief Get number of records in the page buffer
+ * \return
+ *      Records not yet written to storage
+ */
+uint8_t ErriezBMX280PageLog::pending()
+{
+    return _buffered;
+}
+
+/*!
+ * \brief Get number of page writes
+ * \details
+ *      Pages are written in turn, divide by the number of pages in the region for
+ *      the erase cycles per page.
+ * \return
+ *      Page writes since begin()
+ */
+uint32_t ErriezBMX280PageLog::getPageWrites()
+{
+    return _pageWrites;
+}
+
+/*!
+ * \brief Read record
+ * \param age
+ *      0 = newest, count() - 1 = oldest
+ * \param record
+ *      Record
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Age out of range, read failed or record damaged
+ */
+bool ErriezBMX280PageLog::read(uint32_t age, BMX280_LogRecord_t *record)
+{
+    BMX280_PageHeader_t header;
+
+    if (age < _buffered) {
+        memcpy(record, &_buffer[BMX280_PAGE_HEADER_LEN +
+                                (_buffered - 1 - age) * BMX280_LOG_RECORD_LEN],
+               BMX280_LOG_RECORD_LEN);
+        return true;
+    }
+    age -= _buffered;
+
+    // Walk pages from newest to oldest
+    for (uint16_t i = 0; i < _used; i++) {
+        uint16_t page = (_head + _pages - 1 - i) % _pages;
+
+        if (!readHeader(page, &header)) {
+            return false;
+        }
+        if (age < header.count) {
+            if (!_storage->read(pageAddress(page) + BMX280_PAGE_HEADER_LEN +
+                                (uint32_t)(header.count - 1 - age) * BMX280_LOG_RECORD_LEN,
+                                (uint8_t *)record, BMX280_LOG_RECORD_LEN)) {
+                return false;
+            }
+            return bmx280LogRecordValid(record);
+        }
+        age -= header.count;
+    }
+
+    return false;
+}
+
+/*!
+ * \brief Write page buffer to the head page
+ * \details
+ *      Erase, records, header: the header completes the page.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Erase or write failed, the page buffer is kept
+ */
+bool ErriezBMX280PageLog::writePage()
+{
+    BMX280_PageHeader_t header;
+    uint32_t addr = pageAddress(_head);
+    uint8_t overwritten = 0;
+
+    // Records of the oldest page are lost when full
+    if ((_used == _pages) && readHeader(_head, &header)) {
+        overwritten = header.count;
+    }
+
+    memset(&header, 0xFF, sizeof(header));
+    header.count = _buffered;
+    header.sequence = _sequence;
+    header.recordSequence = _recordSequence - _buffered;
+    memcpy(_buffer, &header, BMX280_PAGE_HEADER_LEN);
+    header.crc = bmx280Crc16(&_buffer[2], BMX280_PAGE_HEADER_LEN - 2 +
+                             _buffered * BMX280_LOG_RECORD_LEN);
+    memcpy(_buffer, &header, BMX280_PAGE_HEADER_LEN);
+
+    if (!_storage->erase(addr, _pageSize) ||
+        !_storage->write(addr + BMX280_PAGE_HEADER_LEN, &_buffer[BMX280_PAGE_HEADER_LEN],
+                         _buffered * BMX280_LOG_RECORD_LEN) ||
+        !_storage->write(addr, _buffer, BMX280_PAGE_HEADER_LEN) ||
+        !_storage->sync()) {
+        return false;
+    }
+
+    _pageWrites++;
+    _sequence++;
+    if (++_head >= _pages) {
+        _head = 0;
+    }
+    if (_used < _pages) {
+        _used++;
+    }
+    _records += _buffered - overwritten;
+    _buffered = 0;
+
+    return true;
+}
+
+/*!
+ * \brief Get storage address of a page
+ * \param page
+ *      Page index
+ * \return
+ *      Address
+ */
+uint32_t ErriezBMX280PageLog::pageAddress(uint16_t page)
+{
+    return _offset + (uint32_t)page * _pageSize;
+}
+
+/*!
+ * \brief Read a page header without checking the records
+ * \param page
+ *      Page index
+ * \param header
+ *      Header
+ * \retval true
+ *      Header read, record count in range
+ * \retval false
+ *      Read failed or invalid record count
+ */
+bool ErriezBMX280PageLog::readHeader(uint16_t page, BMX280_PageHeader_t *header)
+{
+    if (!_storage->read(pageAddress(page), (uint8_t *)header, BMX280_PAGE_HEADER_LEN)) {
+        return false;
+    }
+
+    return (header->count > 0) && (header->count <= _recordsPerPage);
+}
+
+/*!
+ * \brief Read and check a complete page
+ * \details
+ *      The records are read one at a time, the page buffer is not used.
+ * \param page
+ *      Page index
+ * \param header
+ *      Header
+ * \retval true
+ *      Valid page
+ * \retval false
+ *      Read failed or no valid page
+ */
+bool ErriezBMX280PageLog::readPage(uint16_t page, BMX280_PageHeader_t *header)
+{
+    BMX280_LogRecord_t record;
+    uint32_t addr = pageAddress(page) + BMX280_PAGE_HEADER_LEN;
+    uint16_t crc;
+
+    if (!readHeader(page, header)) {
+        return false;
+    }
+
+    crc = bmx280Crc16((const uint8_t *)header + 2, BMX280_PAGE_HEADER_LEN - 2);
+    for (uint8_t i = 0; i < header->count; i++) {
+        // Records of an older page under a stale header fail the sequence check
+        if (!_storage->read(addr, (uint8_t *)&record, BMX280_LOG_RECORD_LEN) ||
+            !bmx280LogRecordValid(&record) ||
+            (record.sequence != (uint16_t)(header->recordSequence + i))) {
+            return false;
+        }
+        crc = bmx280Crc16((const uint8_t *)&record, BMX280_LOG_RECORD_LEN, crc);
+        addr += BMX280_LOG_RECORD_LEN;
+    }
+
+    return crc == header->crc;
+}
+
+/*!
+ * \brief Check if a page is valid and has a page sequence number
+ * \param page
+ *      Page index
+ * \param sequence
+ *      Expected page sequence number
+ * \retval true
+ *      Valid page with the page sequence number
+ * \retval false
+ *      Other page or no valid page
+ */
+bool ErriezBMX280PageLog::isPage(uint16_t page, uint32_t sequence)
+{
+    BMX280_PageHeader_t header;
+
+    // Compare the sequence number before reading the records
+    return readHeader(page, &header) && (header.sequence == sequence) &&
+           readPage(page, &header);
+}
@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280PageLog.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Wear-leveled page log for flash and page-write EEPROM
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_PAGE_LOG_H_
+#define ERRIEZ_BMX280_PAGE_LOG_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Log.h"
+#include "ErriezBMX280Storage.h"
+
+#define BMX280_PAGE_HEADER_LEN      16      //!< Page header length in bytes
+#define BMX280_PAGE_MAX_RECORDS     255     //!< Maximum records per page
+
+/*!
+ * \brief Page log header
+ * \details
+ *      16 bytes without padding, little-endian, at the start of each page followed
+ *      by the records. The CRC covers the rest of the header and all records of the
+ *      page. The header is written after the records and acts as commit marker: a
+ *      page is valid when the CRC matches and all records are valid and numbered
+ *      from recordSequence.
+ */
+typedef struct {
+    uint16_t crc;               //!< CRC-16/CCITT of the header from count and the records
+    uint8_t count;              //!< Number of records in the page
+    uint8_t reserved;           //!< 0xFF
+    uint32_t sequence;          //!< Page sequence number, increments per written page
+    uint16_t recordSequence;    //!< Sequence number of the first record
+    uint8_t unused[6];          //!< 0xFF
+} BMX280_PageHeader_t;
+
+/*!
+ * \brief BMX280 page log class
+ * \details
+ *      Records are collected in a page buffer in RAM and written one page at a time
+ *      in a ring of pages, so every page is erased and written once per round. The
+ *      records of a page are written first, the header with the page sequence
+ *      number and CRC last: a page torn by power loss fails its CRC and is skipped.
+ *      begin() finds the newest page with a binary search on the page sequence
+ *      numbers in O(log n) page reads. Records in the page buffer are lost on power
+ *      loss unless flush() is called.
+ */
+class ErriezBMX280PageLog
+{
+public:
+    // Constructor
+    ErriezBMX280PageLog(ErriezBMX280Storage *storage, uint8_t *pageBuffer, uint16_t pageSize,
+                        uint32_t offset = 0, uint32_t length = 0);
+
+    // Initialization
+    bool begin();
+    bool format();
+
+    // Store
+    bool append(const ErriezBMX280Sample &sample, uint32_t timestamp);
+    bool flush();
+
+    // Query, age 0 = newest
+    uint32_t count();
+    uint32_t capacity();
+    uint8_t pending();
+    uint32_t getPageWrites();
+    bool read(uint32_t age, BMX280_LogRecord_t *record);
+
+private:
+    ErriezBMX280Storage *_storage;      //!< Storage
+    uint8_t *_buffer;                   //!< Page buffer, pageSize bytes
+    uint16_t _pageSize;                 //!< Page size in bytes
+    uint32_t _offset;                   //!< Start of the log region in bytes
+    uint32_t _length;                   //!< Length of the log region, 0 = until end
+    uint8_t _recordsPerPage;            //!< Records per page
+    uint16_t _pages;                    //!< Number of pages
+    uint16_t _head;                     //!< Page of the next write
+    uint16_t _used;                     //!< Number of valid pages
+    uint32_t _sequence;                 //!< Sequence number of the next page
+    uint16_t _recordSequence;           //!< Sequence number of the next record
+    uint32_t _records;                  //!< Number of records in valid pages
+    uint8_t _buffered;                  //!< Number of records in the page buffer
+    uint32_t _pageWrites;               //!< Page writes since begin()
+
+    bool writePage();
+    uint32_t pageAddress(uint16_t page);
+    bool readHeader(uint16_t page, BMX280_PageHeader_t *header);
+    bool readPage(uint16_t page, BMX280_PageHeader_t *header);
+    bool isPage(uint16_t page, uint32_t sequence);
+};
+
+#endif // ERRIEZ_BMX280_PAGE_LOG_H_
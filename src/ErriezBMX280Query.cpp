@@ -0,0 +1,239 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Query.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Binary query protocol for sample histories over a serial stream
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280Query.h"
+
+/*!
+ * \brief Constructor
+ * \param histories
+ *      Sample history per sensor, index is the bit in the sensor mask
+ * \param numHistories
+ *      Number of sensors, max BMX280_QUERY_MAX_SENSORS
+ */
+ErriezBMX280QueryServer::ErriezBMX280QueryServer(ErriezBMX280History **histories,
+                                                 uint8_t numHistories) :
+    _histories(histories), _requestLen(0), _requestTime(0)
+{
+    if (numHistories > BMX280_QUERY_MAX_SENSORS) {
+        numHistories = BMX280_QUERY_MAX_SENSORS;
+    }
+    _numHistories = numHistories;
+}
+
+/*!
+ * \brief Receive request bytes and answer a complete request
+ * \details
+ *      Non-blocking, call as often as possible from loop().
+ * \param stream
+ *      Serial stream, for example Serial
+ * \retval true
+ *      Request answered
+ * \retval false
+ *      No complete request
+ */
+bool ErriezBMX280QueryServer::poll(Stream &stream)
+{
+    // Resynchronize on a request which was not completed in time
+    if (_requestLen && ((millis() - _requestTime) > BMX280_QUERY_TIMEOUT_MS)) {
+        _requestLen = 0;
+    }
+
+    while (stream.available() > 0) {
+        if (_requestLen == 0) {
+            _requestTime = millis();
+        }
+        _request[_requestLen++] = stream.read();
+
+        if (_requestLen == BMX280_QUERY_REQUEST_LEN) {
+            _requestLen = 0;
+            handle(stream);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * \brief Answer a complete request
+ * \param stream
+ *      Serial stream
+ */
+void ErriezBMX280QueryServer::handle(Stream &stream)
+{
+    uint8_t mask = _request[1];
+    uint16_t n = _request[2] | ((uint16_t)_request[3] << 8);
+
+    if ((_numHistories < 8) && (mask >> _numHistories)) {
+        writeHeader(stream, BMX280_QUERY_ERR_SENSOR, 0);
+        return;
+    }
+
+    switch (_request[0]) {
+        case BMX280_QUERY_SAMPLES:
+            writeSamples(stream, mask, n);
+            break;
+        case BMX280_QUERY_STATS:
+            writeStats(stream, mask, n);
+            break;
+        default:
+            writeHeader(stream, BMX280_QUERY_ERR_COMMAND, 0);
+    }
+}
+
+/*!
+ * \brief Write sample records
+ * \param stream
+ *      Serial stream
+ * \param mask
+ *      Sensor mask
+ * \param n
+ *      Number of latest samples per sensor
+ */
+void ErriezBMX280QueryServer::writeSamples(Stream &stream, uint8_t mask, uint16_t n)
+{
+    uint32_t now = millis();
+    uint16_t records = 0;
+
+    for (uint8_t i = 0; i < _numHistories; i++) {
+        if (mask & (1 << i)) {
+            records += (_histories[i]->count() < n) ? _histories[i]->count() : n;
+        }
+    }
+
+    writeHeader(stream, BMX280_QUERY_OK, records);
+
+    for (uint8_t i = 0; i < _numHistories; i++) {
+        ErriezBMX280History *history = _histories[i];
+        uint16_t num = (history->count() < n) ? history->count() : n;
+
+        if (!(mask & (1 << i))) {
+            continue;
+        }
+
+        for (uint16_t age = 0; age < num; age++) {
+            ErriezBMX280Sample sample = history->get(age);
+
+            stream.write(i);
+            write32(stream, now - history->getTimestamp(age));
+            write32(stream, (uint32_t)sample.getTemperatureNative());
+            write32(stream, sample.getPressureNative());
+            write32(stream, sample.hasHumidity() ? sample.getHumidityNative() : 0);
+        }
+    }
+}
+
+/*!
+ * \brief Write statistics records
+ * \param stream
+ *      Serial stream
+ * \param mask
+ *      Sensor mask
+ * \param n
+ *      Number of latest samples per sensor
+ */
+void ErriezBMX280QueryServer::writeStats(Stream &stream, uint8_t mask, uint16_t n)
+{
+    BMX280_HistoryStats_t stats;
+    uint16_t records = 0;
+
+    for (uint8_t i = 0; i < _numHistories; i++) {
+        if ((mask & (1 << i)) && _histories[i]->count() && n) {
+            records++;
+        }
+    }
+
+    writeHeader(stream, BMX280_QUERY_OK, records);
+
+    for (uint8_t i = 0; i < _numHistories; i++) {
+        if (!(mask & (1 << i)) || !_histories[i]->getStats(n, &stats)) {
+            continue;
+        }
+
+        stream.write(i);
+        write16(stream, stats.count);
+        write32(stream, (uint32_t)stats.minTemperature);
+        write32(stream, (uint32_t)stats.maxTemperature);
+        write32(stream, (uint32_t)stats.meanTemperature);
+        write32(stream, stats.minPressure);
+        write32(stream, stats.maxPressure);
+        write32(stream, stats.meanPressure);
+        write32(stream, stats.minHumidity);
+        write32(stream, stats.maxHumidity);
+        write32(stream, stats.meanHumidity);
+    }
+}
+
+/*!
+ * \brief Write response header
+ * \param stream
+ *      Serial stream
+ * \param status
+ *      BMX280_QUERY_OK or error
+ * \param records
+ *      Number of records following the header
+ */
+void ErriezBMX280QueryServer::writeHeader(Stream &stream, uint8_t status, uint16_t records)
+{
+    stream.write(_request[0] | BMX280_QUERY_RESPONSE);
+    stream.write(status);
+    write16(stream, records);
+}
+
+/*!
+ * \brief Write 16-bit little-endian value
+ * \param stream
+ *      Serial stream
+ * \param value
+ *      Value
+ */
+void ErriezBMX280QueryServer::write16(Stream &stream, uint16_t value)
+{
+    stream.write((uint8_t)value);
+    stream.write((uint8_t)(value >> 8));
+}
+
+/*!
+ * \brief Write 32-bit little-endian value
+ * \param stream
+ *      Serial stream
+ * \param value
+ *      Value
+ */
+void ErriezBMX280QueryServer::write32(Stream &stream, uint32_t value)
+{
+    write16(stream, (uint16_t)value);
+    write16(stream, (uint16_t)(value >> 16));
+}
@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Query.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Binary query protocol for sample histories over a serial stream
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_QUERY_H_
+#define ERRIEZ_BMX280_QUERY_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280History.h"
+
+// Protocol, all values little-endian
+//
+// Request, 4 bytes:
+//      command, sensor mask (bit 0 = sensor 0), n (uint16)
+// Response:
+//      command | BMX280_QUERY_RESPONSE, status, number of records (uint16), records
+// Sample record, 17 bytes:
+//      sensor, age in ms (uint32), temperature (int32), pressure (uint32), humidity (uint32)
+// Statistics record, 39 bytes:
+//      sensor, count (uint16), min, max, mean temperature (int32),
+//      min, max, mean pressure (uint32), min, max, mean humidity (uint32)
+//
+// Values in native fixed-point units: 0.01 degree Celsius, Pa 24.8, % 22.10.
+
+#define BMX280_QUERY_SAMPLES            0x01    //!< Latest n samples of each sensor, latest first
+#define BMX280_QUERY_STATS              0x02    //!< Statistics of the latest n samples of each sensor
+#define BMX280_QUERY_RESPONSE           0x80    //!< Response bit of command byte
+
+#define BMX280_QUERY_OK                 0x00    //!< Status: Success
+#define BMX280_QUERY_ERR_COMMAND        0x01    //!< Status: Unknown command
+#define BMX280_QUERY_ERR_SENSOR         0x02    //!< Status: Sensor in mask does not exist
+
+#define BMX280_QUERY_REQUEST_LEN        4       //!< Request length
+#define BMX280_QUERY_MAX_SENSORS        8       //!< Sensors in sensor mask
+#define BMX280_QUERY_TIMEOUT_MS         100     //!< Discard incomplete request after timeout
+
+/*!
+ * \brief BMX280 query server class
+ * \details
+ *      Answers requests for the latest samples and statistics of up to 8 sensors
+ *      from their histories in RAM, without bus access. One request can query
+ *      several sensors.
+ */
+class ErriezBMX280QueryServer
+{
+public:
+    // Constructor
+    ErriezBMX280QueryServer(ErriezBMX280History **histories, uint8_t numHistories);
+
+    // Call from loop()
+    bool poll(Stream &stream);
+
+private:
+    ErriezBMX280History **_histories;   //!< Sample history per sensor
+    uint8_t _numHistories;              //!< Number of sensors
+    uint8_t _request[BMX280_QUERY_REQUEST_LEN]; //!< Received request bytes
+    uint8_t _requestLen;                //!< Number of received request bytes
+    uint32_t _requestTime;              //!< millis() of first request byte
+
+    void handle(Stream &stream);
+    void writeSamples(Stream &stream, uint8_t mask, uint16_t n);
+    void writeStats(Stream &stream, uint8_t mask, uint16_t n);
+    void writeHeader(Stream &stream, uint8_t status, uint16_t records);
+    void write16(Stream &stream, uint16_t value);
+    void write32(Stream &stream, uint32_t value);
+};
+
+#endif // ERRIEZ_BMX280_QUERY_H_
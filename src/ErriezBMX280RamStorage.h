@@ -0,0 +1,195 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280RamStorage.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      RAM storage for sample logs with optional wear counters
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_RAM_STORAGE_H_
+#define ERRIEZ_BMX280_RAM_STORAGE_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Storage.h"
+
+/*!
+ * \brief BMX280 RAM storage class
+ * \details
+ *      Header only. Storage in an application buffer, for volatile logs, host tests
+ *      and endurance benchmarks without wearing real memory. With counters, each
+ *      cell counts a write cycle per write of a changed byte. erase() is not counted:
+ *      the following write of the erased bytes counts the cycle.
+ */
+class ErriezBMX280RamStorage : public ErriezBMX280Storage
+{
+public:
+    /*!
+     * \brief Constructor
+     * \param mem
+     *      Memory, initialized erased (0xFF) by the constructor
+     * \param size
+     *      Size in bytes
+     * \param cellWrites
+     *      Write counter per byte, size counters, NULL = no counting
+     */
+    ErriezBMX280RamStorage(uint8_t *mem, uint32_t size, uint16_t *cellWrites = NULL) :
+        _mem(mem), _size(size), _cellWrites(cellWrites)
+    {
+        memset(_mem, 0xFF, _size);
+        resetCellWrites();
+    }
+
+    /*!
+     * \brief Read bytes
+     * \param addr
+     *      Start address
+     * \param buffer
+     *      Buffer to store bytes
+     * \param len
+     *      Number of bytes
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Range outside the memory
+     */
+    bool read(uint32_t addr, uint8_t *buffer, uint16_t len)
+    {
+        if ((addr > _size) || (len > (_size - addr))) {
+            return false;
+        }
+        memcpy(buffer, &_mem[addr], len);
+
+        return true;
+    }
+
+    /*!
+     * \brief Write bytes
+     * \param addr
+     *      Start address
+     * \param buffer
+     *      Bytes to write
+     * \param len
+     *      Number of bytes
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Range outside the memory
+     */
+    bool write(uint32_t addr, const uint8_t *buffer, uint16_t len)
+    {
+        if ((addr > _size) || (len > (_size - addr))) {
+            return false;
+        }
+        for (uint16_t i = 0; i < len; i++) {
+            program(addr + i, buffer[i]);
+        }
+
+        return true;
+    }
+
+    /*!
+     * \brief Erase bytes to 0xFF
+     * \param addr
+     *      Start address
+     * \param len
+     *      Number of bytes
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Range outside the memory
+     */
+    bool erase(uint32_t addr, uint32_t len)
+    {
+        if ((addr > _size) || (len > (_size - addr))) {
+            return false;
+        }
+        memset(&_mem[addr], 0xFF, len);
+
+        return true;
+    }
+
+    /*!
+     * \brief Get storage size
+     * \return
+     *      Size in bytes
+     */
+    uint32_t size()
+    {
+        return _size;
+    }
+
+    /*!
+     * \brief Get write cycles of a cell
+     * \param addr
+     *      Address
+     * \return
+     *      Write cycles, saturates at 65535, 0 without counters
+     */
+    uint16_t getCellWrites(uint32_t addr)
+    {
+        return (_cellWrites && (addr < _size)) ? _cellWrites[addr] : 0;
+    }
+
+    /*!
+     * \brief Clear write counters
+     */
+    void resetCellWrites()
+    {
+        if (_cellWrites) {
+            memset(_cellWrites, 0, _size * sizeof(uint16_t));
+        }
+    }
+
+private:
+    uint8_t *_mem;              //!< Memory
+    uint32_t _size;             //!< Size in bytes
+    uint16_t *_cellWrites;      //!< Write counter per byte, NULL = none
+
+    /*!
+     * \brief Program a byte and count a write cycle when it changes
+     * \param addr
+     *      Address
+     * \param value
+     *      Byte
+     */
+    void program(uint32_t addr, uint8_t value)
+    {
+        if (_mem[addr] == value) {
+            return;
+        }
+        _mem[addr] = value;
+        if (_cellWrites && (_cellWrites[addr] < 0xFFFF)) {
+            _cellWrites[addr]++;
+        }
+    }
+};
+
+#endif // ERRIEZ_BMX280_RAM_STORAGE_H_
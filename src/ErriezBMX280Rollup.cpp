@@ -0,0 +1,348 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Rollup.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Incremental time bucket rollups with mergeable aggregates
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280Rollup.h"
+
+/*!
+ * \brief Clear aggregate
+ * \param aggregate
+ *      Aggregate
+ */
+void bmx280AggregateClear(BMX280_Aggregate_t *aggregate)
+{
+    aggregate->sum = 0;
+    aggregate->sumSquares = 0;
+    aggregate->count = 0;
+    aggregate->min = INT32_MAX;
+    aggregate->max = INT32_MIN;
+}
+
+/*!
+ * \brief Add value to aggregate
+ * \param aggregate
+ *      Aggregate
+ * \param value
+ *      Value
+ */
+void bmx280AggregateAdd(BMX280_Aggregate_t *aggregate, int32_t value)
+{
+    aggregate->sum += value;
+    aggregate->sumSquares += (uint64_t)((int64_t)value * value);
+    aggregate->count++;
+    if (value < aggregate->min) {
+        aggregate->min = value;
+    }
+    if (value > aggregate->max) {
+        aggregate->max = value;
+    }
+}
+
+/*!
+ * \brief Merge aggregate of a disjoint set of values
+ * \param aggregate
+ *      Aggregate to update
+ * \param other
+ *      Aggregate to merge
+ */
+void bmx280AggregateMerge(BMX280_Aggregate_t *aggregate, const BMX280_Aggregate_t *other)
+{
+    if (other->count == 0) {
+        return;
+    }
+
+    aggregate->sum += other->sum;
+    aggregate->sumSquares += other->sumSquares;
+    aggregate->count += other->count;
+    if (other->min < aggregate->min) {
+        aggregate->min = other->min;
+    }
+    if (other->max > aggregate->max) {
+        aggregate->max = other->max;
+    }
+}
+
+/*!
+ * \brief Get mean
+ * \param aggregate
+ *      Aggregate
+ * \return
+ *      Mean, 0 without values
+ */
+float bmx280AggregateMean(const BMX280_Aggregate_t *aggregate)
+{
+    int64_t mean;
+
+    if (aggregate->count == 0) {
+        return 0;
+    }
+
+    // Integer part and remainder keep the precision of large sums
+    mean = aggregate->sum / (int64_t)aggregate->count;
+
+    return (float)mean + (float)(aggregate->sum - (mean * aggregate->count)) / aggregate->count;
+}
+
+/*!
+ * \brief Get population variance
+ * \details
+ *      The squared deviations from the integer mean m are calculated exactly as
+ *      sumSquares - m * (sum + r) with remainder r = sum - m * count, so the float
+ *      result does not suffer from cancellation of the large sums.
+ * \param aggregate
+ *      Aggregate
+ * \return
+ *      Variance in squared channel units, 0 without values
+ */
+float bmx280AggregateVariance(const BMX280_Aggregate_t *aggregate)
+{
+    int64_t mean;
+    int64_t remainder;
+    int64_t deviations;
+
+    if (aggregate->count == 0) {
+        return 0;
+    }
+
+    mean = aggregate->sum / (int64_t)aggregate->count;
+    remainder = aggregate->sum - (mean * aggregate->count);
+    deviations = (int64_t)aggregate->sumSquares - (mean * (aggregate->sum + remainder));
+
+    return ((float)deviations - ((float)remainder * remainder / aggregate->count)) /
+           aggregate->count;
+}
+
+/*!
+ * \brief Clear all aggregates of a bucket
+ * \param bucket
+ *      Bucket
+ */
+void bmx280RollupBucketClear(BMX280_RollupBucket_t *bucket)
+{
+    bucket->start = 0;
+    for (uint8_t i = 0; i < BMX280_ROLLUP_CHANNELS; i++) {
+        bmx280AggregateClear(&bucket->channel[i]);
+    }
+}
+
+/*!
+ * \brief Merge bucket, for example the same bucket of another sensor
+ * \param bucket
+ *      Bucket to update, takes the start time of the other bucket when empty
+ * \param other
+ *      Bucket to merge
+ */
+void bmx280RollupBucketMerge(BMX280_RollupBucket_t *bucket, const BMX280_RollupBucket_t *other)
+{
+    bool empty = true;
+
+    for (uint8_t i = 0; i < BMX280_ROLLUP_CHANNELS; i++) {
+        if (bucket->channel[i].count) {
+            empty = false;
+        }
+    }
+    if (empty) {
+        bucket->start = other->start;
+    }
+
+    for (uint8_t i = 0; i < BMX280_ROLLUP_CHANNELS; i++) {
+        bmx280AggregateMerge(&bucket->channel[i], &other->channel[i]);
+    }
+}
+
+/*!
+ * \brief Constructor
+ * \param levels
+ *      Level storage
+ * \param numLevels
+ *      Number of levels, maximum BMX280_ROLLUP_MAX_LEVELS
+ */
+ErriezBMX280Rollup::ErriezBMX280Rollup(BMX280_RollupLevel_t *levels, uint8_t numLevels) :
+    _levels(levels),
+    _numLevels((numLevels > BMX280_ROLLUP_MAX_LEVELS) ? BMX280_ROLLUP_MAX_LEVELS : numLevels)
+{
+    for (uint8_t i = 0; i < _numLevels; i++) {
+        _levels[i].duration = 1;
+    }
+    reset();
+}
+
+/*!
+ * \brief Set bucket duration of a level
+ * \details
+ *      Set the levels in order, first level first. Clears the current bucket.
+ * \param level
+ *      Level index
+ * \param duration
+ *      Duration in timestamp units, a multiple of the duration of the previous level
+ * \retval true
+ *      Success
+ * \retval false
+ *      Error: Invalid level or duration
+ */
+bool ErriezBMX280Rollup::setDuration(uint8_t level, uint32_t duration)
+{
+    if ((level >= _numLevels) || (duration == 0) ||
+        ((level > 0) && ((duration % _levels[level - 1].duration) != 0))) {
+        return false;
+    }
+
+    _levels[level].duration = duration;
+    bmx280RollupBucketClear(&_levels[level].current);
+
+    return true;
+}
+
+/*!
+ * \brief Clear current and completed buckets of all levels
+ */
+void ErriezBMX280Rollup::reset()
+{
+    for (uint8_t i = 0; i < _numLevels; i++) {
+        bmx280RollupBucketClear(&_levels[i].current);
+        bmx280RollupBucketClear(&_levels[i].last);
+    }
+}
+
+/*!
+ * \brief Add sample
+ * \details
+ *      Pressure is aggregated in Pa, so the sum of squares of one channel holds more
+ *      than 10^8 samples.
+ * \param sample
+ *      Sample, invalid samples are ignored
+ * \param timestamp
+ *      Application time, for example RTC seconds, must not decrease
+ * \return
+ *      Bit mask of levels with a completed bucket
+ */
+uint8_t ErriezBMX280Rollup::add(ErriezBMX280Sample &sample, uint32_t timestamp)
+{
+    int32_t values[BMX280_ROLLUP_CHANNELS];
+
+    if (!sample.isValid()) {
+        return 0;
+    }
+
+    values[BMX280_ROLLUP_TEMPERATURE] = sample.getTemperatureNative();
+    values[BMX280_ROLLUP_PRESSURE] = (sample.getPressureNative() + 128) >> 8;
+    values[BMX280_ROLLUP_HUMIDITY] = sample.getHumidityNative();
+
+    return add(values, sample.hasHumidity() ? 3 : 2, timestamp);
+}
+
+/*!
+ * \brief Add values
+ * \details
+ *      A timestamp after the current bucket of a level completes the bucket, which
+ *      is merged into the next level before that level checks the timestamp.
+ * \param values
+ *      Values in channel units, see BMX280_ROLLUP_TEMPERATURE
+ * \param numValues
+ *      Number of values, 2 without humidity
+ * \param timestamp
+ *      Application time, for example RTC seconds, must not decrease
+ * \return
+ *      Bit mask of levels with a completed bucket
+ */
+uint8_t ErriezBMX280Rollup::add(const int32_t *values, uint8_t numValues, uint32_t timestamp)
+{
+    uint8_t completed = 0;
+    BMX280_RollupBucket_t *bucket;
+
+    if (_numLevels == 0) {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < _numLevels; i++) {
+        BMX280_RollupLevel_t *level = &_levels[i];
+
+        // Buckets of the next levels can only complete with this level
+        if ((level->current.channel[BMX280_ROLLUP_TEMPERATURE].count == 0) ||
+            (level->current.start == (timestamp - (timestamp % level->duration)))) {
+            break;
+        }
+
+        level->last = level->current;
+        if ((i + 1) < _numLevels) {
+            bucket = &_levels[i + 1].current;
+            bmx280RollupBucketMerge(bucket, &level->current);
+            bucket->start -= bucket->start % _levels[i + 1].duration;
+        }
+        bmx280RollupBucketClear(&level->current);
+        completed |= (1 << i);
+    }
+
+    bucket = &_levels[0].current;
+    if (bucket->channel[BMX280_ROLLUP_TEMPERATURE].count == 0) {
+        bucket->start = timestamp - (timestamp % _levels[0].duration);
+    }
+    for (uint8_t i = 0; (i < numValues) && (i < BMX280_ROLLUP_CHANNELS); i++) {
+        bmx280AggregateAdd(&bucket->channel[i], values[i]);
+    }
+
+    return completed;
+}
+
+/*!
+ * \brief Get last completed bucket of a level
+ * \param level
+ *      Level index
+ * \return
+ *      Bucket, no values before the first bucket completed, NULL for an invalid level
+ */
+const BMX280_RollupBucket_t *ErriezBMX280Rollup::getBucket(uint8_t level)
+{
+    if (level >= _numLevels) {
+        return NULL;
+    }
+
+    return &_levels[level].last;
+}
+
+/*!
+ * \brief Get bucket being filled of a level
+ * \param level
+ *      Level index
+ * \return
+ *      Bucket, NULL for an invalid level
+ */
+const BMX280_RollupBucket_t *ErriezBMX280Rollup::getCurrent(uint8_t level)
+{
+    if (level >= _numLevels) {
+        return NULL;
+    }
+
+    return &_levels[level].current;
+}
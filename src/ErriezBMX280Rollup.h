@@ -0,0 +1,124 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Rollup.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Incremental time bucket rollups with mergeable aggregates
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_ROLLUP_H_
+#define ERRIEZ_BMX280_ROLLUP_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Sample.h"
+
+#define BMX280_ROLLUP_TEMPERATURE   0       //!< Channel temperature 0.01 degree Celsius
+#define BMX280_ROLLUP_PRESSURE      1       //!< Channel pressure Pa
+#define BMX280_ROLLUP_HUMIDITY      2       //!< Channel humidity % 22.10
+#define BMX280_ROLLUP_CHANNELS      3       //!< Number of channels
+#define BMX280_ROLLUP_MAX_LEVELS    8       //!< Maximum number of levels
+
+/*!
+ * \brief Mergeable aggregate of one channel
+ * \details
+ *      Aggregates of disjoint sample sets merge into the aggregate of the union, for
+ *      example the minutes of an hour or the same hour of several sensors.
+ */
+typedef struct {
+    int64_t sum;                //!< Sum of values
+    uint64_t sumSquares;        //!< Sum of squared values
+    uint32_t count;             //!< Number of values
+    int32_t min;                //!< Minimum value
+    int32_t max;                //!< Maximum value
+} BMX280_Aggregate_t;
+
+/*!
+ * \brief Aggregates of all channels in a time bucket
+ */
+typedef struct {
+    uint32_t start;             //!< Start time, a multiple of the bucket duration
+    BMX280_Aggregate_t channel[BMX280_ROLLUP_CHANNELS];  //!< See BMX280_ROLLUP_TEMPERATURE
+} BMX280_RollupBucket_t;
+
+/*!
+ * \brief Rollup level
+ * \details
+ *      Storage is provided by the application, fields are managed by the rollup.
+ */
+typedef struct {
+    BMX280_RollupBucket_t current;  //!< Bucket being filled
+    BMX280_RollupBucket_t last;     //!< Last completed bucket
+    uint32_t duration;              //!< Bucket duration in timestamp units
+} BMX280_RollupLevel_t;
+
+// Aggregates
+void bmx280AggregateClear(BMX280_Aggregate_t *aggregate);
+void bmx280AggregateAdd(BMX280_Aggregate_t *aggregate, int32_t value);
+void bmx280AggregateMerge(BMX280_Aggregate_t *aggregate, const BMX280_Aggregate_t *other);
+float bmx280AggregateMean(const BMX280_Aggregate_t *aggregate);
+float bmx280AggregateVariance(const BMX280_Aggregate_t *aggregate);
+void bmx280RollupBucketClear(BMX280_RollupBucket_t *bucket);
+void bmx280RollupBucketMerge(BMX280_RollupBucket_t *bucket, const BMX280_RollupBucket_t *other);
+
+/*!
+ * \brief BMX280 rollup class
+ * \details
+ *      Aggregates a sample stream of one sensor into time buckets of several levels,
+ *      for example 1 s, 1 min and 1 h. A sample updates the current bucket of the
+ *      first level only. A completed bucket is merged into the current bucket of the
+ *      next level, so the cost per sample is constant. Durations are multiples of
+ *      the duration of the previous level, buckets start at multiples of their
+ *      duration.
+ */
+class ErriezBMX280Rollup
+{
+public:
+    // Constructor
+    ErriezBMX280Rollup(BMX280_RollupLevel_t *levels, uint8_t numLevels);
+
+    // Configuration
+    bool setDuration(uint8_t level, uint32_t duration);
+    void reset();
+
+    // Input
+    uint8_t add(ErriezBMX280Sample &sample, uint32_t timestamp);
+    uint8_t add(const int32_t *values, uint8_t numValues, uint32_t timestamp);
+
+    // Output
+    const BMX280_RollupBucket_t *getBucket(uint8_t level);
+    const BMX280_RollupBucket_t *getCurrent(uint8_t level);
+
+private:
+    BMX280_RollupLevel_t *_levels;      //!< Level storage
+    uint8_t _numLevels;                 //!< Number of levels
+};
+
+#endif // ERRIEZ_BMX280_ROLLUP_H_
@@ -0,0 +1,167 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280SPI.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      SPI bus interface with batched multi-sensor reads
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280SPI.h"
+
+/*!
+ * \brief Constructor
+ * \param spi
+ *      SPI bus, default SPI
+ * \param clock
+ *      SPI clock in Hz, max BMX280_SPI_CLOCK
+ */
+ErriezBMX280SPI::ErriezBMX280SPI(SPIClass &spi, uint32_t clock) :
+    _spi(&spi), _settings(clock, MSBFIRST, SPI_MODE0)
+{
+
+}
+
+/*!
+ * \brief Initialize SPI bus
+ */
+void ErriezBMX280SPI::begin()
+{
+    _spi->begin();
+}
+
+/*!
+ * \brief Initialize chip select pin of a sensor
+ * \details
+ *      Call before ErriezBMX280::begin(). The sensor selects the SPI interface on
+ *      the first falling edge of chip select, so the pin is driven high first.
+ * \param csPin
+ *      Chip select pin
+ */
+void ErriezBMX280SPI::beginDevice(uint8_t csPin)
+{
+    digitalWrite(csPin, HIGH);
+    pinMode(csPin, OUTPUT);
+}
+
+/*!
+ * \brief Burst read from consecutive registers
+ * \param csPin
+ *      Chip select pin
+ * \param reg
+ *      First register address
+ * \param buffer
+ *      Buffer to store register values
+ * \param len
+ *      Number of registers
+ * \retval true
+ *      Success
+ */
+bool ErriezBMX280SPI::read(uint8_t csPin, uint8_t reg, uint8_t *buffer, uint8_t len)
+{
+    _spi->beginTransaction(_settings);
+    transfer(csPin, reg, buffer, len);
+    _spi->endTransaction();
+
+    return true;
+}
+
+/*!
+ * \brief Write to 8-bit register
+ * \param csPin
+ *      Chip select pin
+ * \param reg
+ *      Register address
+ * \param value
+ *      8-bit register value
+ * \retval true
+ *      Success
+ */
+bool ErriezBMX280SPI::write(uint8_t csPin, uint8_t reg, uint8_t value)
+{
+    _spi->beginTransaction(_settings);
+    digitalWrite(csPin, LOW);
+    _spi->transfer(reg & ~BMX280_SPI_READ);
+    _spi->transfer(value);
+    digitalWrite(csPin, HIGH);
+    _spi->endTransaction();
+
+    return true;
+}
+
+/*!
+ * \brief Burst read the same registers of several sensors
+ * \details
+ *      All sensors are read in one SPI transaction, only chip select toggles between
+ *      the sensors. Use it to read the data registers of all sensors on the bus with
+ *      one bus arbitration instead of one per sensor.
+ * \param csPins
+ *      Chip select pins
+ * \param count
+ *      Number of sensors
+ * \param reg
+ *      First register address
+ * \param buffer
+ *      Buffer to store register values: count * len bytes, in csPins order
+ * \param len
+ *      Number of registers per sensor
+ * \retval true
+ *      Success
+ */
+bool ErriezBMX280SPI::readBatch(const uint8_t *csPins, uint8_t count, uint8_t reg,
+                                uint8_t *buffer, uint8_t len)
+{
+    _spi->beginTransaction(_settings);
+    for (uint8_t i = 0; i < count; i++) {
+        transfer(csPins[i], reg, &buffer[i * len], len);
+    }
+    _spi->endTransaction();
+
+    return true;
+}
+
+/*!
+ * \brief Burst read within a transaction
+ * \param csPin
+ *      Chip select pin
+ * \param reg
+ *      First register address
+ * \param buffer
+ *      Buffer to store register values
+ * \param len
+ *      Number of registers
+ */
+void ErriezBMX280SPI::transfer(uint8_t csPin, uint8_t reg, uint8_t *buffer, uint8_t len)
+{
+    digitalWrite(csPin, LOW);
+    _spi->transfer(reg | BMX280_SPI_READ);
+    memset(buffer, 0, len);
+    _spi->transfer(buffer, len);
+    digitalWrite(csPin, HIGH);
+}
@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280SPI.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      SPI bus interface with batched multi-sensor reads
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_SPI_H_
+#define ERRIEZ_BMX280_SPI_H_
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#include "ErriezBMX280Bus.h"
+
+// SPI register address bit 7: 1 = read, 0 = write
+#define BMX280_SPI_READ             0x80    //!< SPI read bit
+
+// Maximum SPI clock
+#define BMX280_SPI_CLOCK            10000000UL  //!< 10MHz
+
+/*!
+ * \brief BMX280 SPI bus class
+ * \details
+ *      The device address of the sensor is the chip select pin:
+ *      ErriezBMX280(csPin, &spiBus). SPI mode 0, MSB first.
+ */
+class ErriezBMX280SPI : public ErriezBMX280Bus
+{
+public:
+    explicit ErriezBMX280SPI(SPIClass &spi = SPI, uint32_t clock = BMX280_SPI_CLOCK);
+
+    void begin();
+    void beginDevice(uint8_t csPin);
+
+    bool read(uint8_t csPin, uint8_t reg, uint8_t *buffer, uint8_t len);
+    bool write(uint8_t csPin, uint8_t reg, uint8_t value);
+    bool readBatch(const uint8_t *csPins, uint8_t count, uint8_t reg,
+                   uint8_t *buffer, uint8_t len);
+
+private:
+    SPIClass *_spi;             //!< SPI bus
+    SPISettings _settings;      //!< Clock, bit order and mode of the sensors
+
+    void transfer(uint8_t csPin, uint8_t reg, uint8_t *buffer, uint8_t len);
+};
+
+#endif // ERRIEZ_BMX280_SPI_H_
@@ -0,0 +1,226 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Sample.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Sample of one burst read, compensated per channel on first access
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280Sample.h"
+
+// Sample flags
+#define SAMPLE_HUMIDITY         (1 << 0)    //!< Humidity channel available
+#define SAMPLE_TEMPERATURE_OK   (1 << 1)    //!< Temperature compensated
+#define SAMPLE_PRESSURE_OK      (1 << 2)    //!< Pressure compensated
+#define SAMPLE_HUMIDITY_OK      (1 << 3)    //!< Humidity compensated
+
+/*!
+ * \brief Constructor of an invalid sample
+ */
+ErriezBMX280Sample::ErriezBMX280Sample() : _calib(NULL), _pressCache(NULL), _t_fine(0), _flags(0)
+{
+    _raw.adc_T = 0;
+    _raw.adc_P = 0;
+    _raw.adc_H = 0;
+}
+
+/*!
+ * \brief Constructor
+ * \param calib
+ *      Compensation coefficients of the sensor
+ * \param raw
+ *      Uncompensated burst
+ * \param humidity
+ *      true: BME280 humidity channel available
+ * \param pressCache
+ *      Pressure terms shared with the sensor, NULL = calculate per sample
+ */
+ErriezBMX280Sample::ErriezBMX280Sample(const BMX280_Calib_t *calib, const BMX280_Raw_t &raw,
+                                       bool humidity, BMX280_PressureCache_t *pressCache) :
+    _calib(calib), _pressCache(pressCache), _raw(raw), _t_fine(0),
+    _flags(humidity ? SAMPLE_HUMIDITY : 0)
+{
+
+}
+
+/*!
+ * \brief Check if sample holds a successful burst read
+ * \retval true
+ *      Valid sample
+ * \retval false
+ *      Error: Bus read failed or sensor not initialized
+ */
+bool ErriezBMX280Sample::isValid() const
+{
+    return _calib != NULL;
+}
+
+/*!
+ * \brief Check if sample holds a humidity channel
+ * \retval true
+ *      BME280 sample
+ * \retval false
+ *      BMP280 sample
+ */
+bool ErriezBMX280Sample::hasHumidity() const
+{
+    return (_flags & SAMPLE_HUMIDITY) ? true : false;
+}
+
+/*!
+ * \brief Get uncompensated burst
+ * \return
+ *      Raw ADC values
+ */
+const BMX280_Raw_t &ErriezBMX280Sample::getRaw() const
+{
+    return _raw;
+}
+
+/*!
+ * \brief Get compensation coefficients
+ * \return
+ *      Coefficients of the sensor, NULL for an invalid sample
+ */
+const BMX280_Calib_t *ErriezBMX280Sample::getCalib() const
+{
+    return _calib;
+}
+
+/*!
+ * \brief Get temperature
+ * \return
+ *      Temperature (float)
+ */
+float ErriezBMX280Sample::getTemperature()
+{
+    return getTemperatureNative() / 100.0;
+}
+
+/*!
+ * \brief Get pressure
+ * \return
+ *      Pressure (float)
+ */
+float ErriezBMX280Sample::getPressure()
+{
+    return (float)getPressureNative() / 256;
+}
+
+/*!
+ * \brief Get approximate altitude
+ * \param seaLevel
+ *      Sea level in hPa
+ * \return
+ *      Altitude (float)
+ */
+float ErriezBMX280Sample::getAltitude(float seaLevel)
+{
+    float atmospheric = getPressure() / 100.0F;
+
+    // In Si units for Pascal
+    return 44330.0 * (1.0 - pow(atmospheric / seaLevel, 0.1903));
+}
+
+/*!
+ * \brief Get humidity (BME280 only)
+ * \return
+ *      Humidity (float)
+ */
+float ErriezBMX280Sample::getHumidity()
+{
+    return getHumidityNative() / 1024.0;
+}
+
+/*!
+ * \brief Get temperature, compensated on first call
+ * \return
+ *      Temperature in 0.01 degree Celsius
+ */
+int32_t ErriezBMX280Sample::getTemperatureNative()
+{
+    if (_calib == NULL) {
+        return 0;
+    }
+
+    if (!(_flags & SAMPLE_TEMPERATURE_OK)) {
+        _temperature = bmx280CompensateTFast(_calib, _raw.adc_T, &_t_fine);
+        _flags |= SAMPLE_TEMPERATURE_OK;
+    }
+
+    return _temperature;
+}
+
+/*!
+ * \brief Get pressure, compensated on first call
+ * \return
+ *      Pressure in Pa as unsigned 24.8 fixed-point
+ */
+uint32_t ErriezBMX280Sample::getPressureNative()
+{
+    if (_calib == NULL) {
+        return 0;
+    }
+
+    if (!(_flags & SAMPLE_PRESSURE_OK)) {
+        // Compensate temperature for t_fine
+        getTemperatureNative();
+
+        if (_pressCache) {
+            _pressure = bmx280CompensatePCached(_calib, _pressCache, _raw.adc_P, _t_fine);
+        } else {
+            _pressure = bmx280CompensateP(_calib, _raw.adc_P, _t_fine);
+        }
+        _flags |= SAMPLE_PRESSURE_OK;
+    }
+
+    return _pressure;
+}
+
+/*!
+ * \brief Get humidity, compensated on first call (BME280 only)
+ * \return
+ *      Relative humidity in % as unsigned 22.10 fixed-point
+ */
+uint32_t ErriezBMX280Sample::getHumidityNative()
+{
+    if ((_calib == NULL) || !(_flags & SAMPLE_HUMIDITY)) {
+        return 0;
+    }
+
+    if (!(_flags & SAMPLE_HUMIDITY_OK)) {
+        // Compensate temperature for t_fine
+        getTemperatureNative();
+
+        _humidity = bmx280CompensateHFast(_calib, _raw.adc_H, _t_fine);
+        _flags |= SAMPLE_HUMIDITY_OK;
+    }
+
+    return _humidity;
+}
@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Sample.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Sample of one burst read, compensated per channel on first access
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_SAMPLE_H_
+#define ERRIEZ_BMX280_SAMPLE_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Compensate.h"
+
+/*!
+ * \brief BMX280 sample class
+ * \details
+ *      Holds the uncompensated burst and a pointer to the coefficients of the
+ *      sensor it was read from. Each channel is compensated on first access and
+ *      cached. The coefficients must outlive the sample.
+ */
+class ErriezBMX280Sample
+{
+public:
+    // Constructors
+    ErriezBMX280Sample();
+    ErriezBMX280Sample(const BMX280_Calib_t *calib, const BMX280_Raw_t &raw, bool humidity,
+                       BMX280_PressureCache_t *pressCache = NULL);
+
+    bool isValid() const;
+    bool hasHumidity() const;
+    const BMX280_Raw_t &getRaw() const;
+    const BMX280_Calib_t *getCalib() const;
+
+    // Compensated values
+    float getTemperature();
+    float getPressure();
+    float getAltitude(float seaLevel);
+    float getHumidity();
+
+    // Native fixed-point values
+    int32_t getTemperatureNative();
+    uint32_t getPressureNative();
+    uint32_t getHumidityNative();
+
+private:
+    const BMX280_Calib_t *_calib;   //!< Coefficients, NULL when invalid
+    BMX280_PressureCache_t *_pressCache; //!< Pressure terms of the sensor, optional
+    BMX280_Raw_t _raw;              //!< Uncompensated burst
+    int32_t _t_fine;                //!< Temperature variable
+    int32_t _temperature;           //!< Cached temperature 0.01 degree Celsius
+    uint32_t _pressure;             //!< Cached pressure Pa 24.8
+    uint32_t _humidity;             //!< Cached humidity % 22.10
+    uint8_t _flags;                 //!< Compensated channels
+};
+
+#endif // ERRIEZ_BMX280_SAMPLE_H_
@@ -0,0 +1,468 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Scheduler.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Non-blocking earliest-deadline-first scheduler for sensors on a shared bus
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280Scheduler.h"
+
+/*!
+ * \brief Constructor
+ * \param tasks
+ *      Task storage, one entry per sensor
+ * \param maxTasks
+ *      Number of entries in task storage
+ * \param callback
+ *      Called for each burst sample
+ */
+ErriezBMX280Scheduler::ErriezBMX280Scheduler(BMX280_Task_t *tasks, uint8_t maxTasks,
+                                             BMX280_SampleCallback callback) :
+    _tasks(tasks), _maxTasks(maxTasks), _numTasks(0), _callback(callback),
+    _statsTime(micros()), _elapsedTime(0), _busyTime(0)
+{
+
+}
+
+/*!
+ * \brief Add sensor
+ * \details
+ *      Forced mode sensors are triggered once per period. Normal mode sensors are only
+ *      read, the sample period of the sensor should be shorter than periodMs.
+ * \param sensor
+ *      Initialized sensor
+ * \param periodMs
+ *      Sample period in ms, at least 1
+ * \param priority
+ *      Priority, higher values are scheduled first
+ * \param quota
+ *      Maximum share of bus time in 1/1000, BMX280_QUOTA_UNLIMITED = no limit
+ * \return
+ *      Task index, -1 when task storage is full or the period is 0
+ */
+int8_t ErriezBMX280Scheduler::addSensor(ErriezBMX280 *sensor, uint16_t periodMs,
+                                        uint8_t priority, uint16_t quota)
+{
+    BMX280_Task_t *t;
+
+    if ((_numTasks >= _maxTasks) || (periodMs == 0)) {
+        return -1;
+    }
+
+    t = &_tasks[_numTasks];
+    t->sensor = sensor;
+    t->period = periodMs * 1000UL;
+    t->release = micros();
+    t->readyAt = t->release;
+    t->maxLatency = 0;
+    t->maxJitter = 0;
+    t->jitterSum = 0;
+    t->credit = 0;
+    t->refill = t->release;
+    t->quota = quota;
+    t->busTime = 0;
+    t->misses = 0;
+    t->samples = 0;
+    t->priority = priority;
+    t->state = BMX280_TASK_IDLE;
+
+    return _numTasks++;
+}
+
+/*!
+ * \brief Check if all deadlines can be met
+ * \details
+ *      Requires the bus utilization to be below 100% and each conversion plus the bus
+ *      transactions of all sensors to fit in the shortest period. Bus times are measured
+ *      while running, so call this after the first samples.
+ * \retval true
+ *      All deadlines can be met
+ * \retval false
+ *      Deadlines will be missed
+ */
+bool ErriezBMX280Scheduler::isFeasible()
+{
+    uint64_t utilization = 0;   // Bus utilization in 1/65536
+    uint64_t blocking = 0;      // Worst case bus time of all other transactions
+
+    for (uint8_t i = 0; i < _numTasks; i++) {
+        utilization += (((uint64_t)_tasks[i].busTime * 2) << 16) / _tasks[i].period;
+        blocking += (uint64_t)_tasks[i].busTime * 2;
+    }
+    if (utilization >= 65536UL) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < _numTasks; i++) {
+        BMX280_Task_t *t = &_tasks[i];
+        uint32_t conversion = 0;
+
+        if (t->sensor->getMode() != BMX280_MODE_NORMAL) {
+            conversion = t->sensor->getConversionTime();
+        }
+        if ((conversion + blocking) > t->period) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Perform the pending bus transaction with the highest priority and earliest deadline
+ * \details
+ *      Non-blocking, call as often as possible from loop().
+ * \retval true
+ *      Bus transaction performed
+ * \retval false
+ *      Nothing to do
+ */
+bool ErriezBMX280Scheduler::run()
+{
+    uint32_t now = micros();
+    int32_t earliest = 0;
+    int8_t best = -1;
+
+    uint32_t ready;
+
+    updateElapsed(now);
+
+    for (uint8_t i = 0; i < _numTasks; i++) {
+        BMX280_Task_t *t = &_tasks[i];
+        int32_t deadline = (int32_t)(t->release + t->period - now);
+
+        ready = (t->state == BMX280_TASK_IDLE) ? t->release : t->readyAt;
+        if ((int32_t)(now - ready) < 0) {
+            continue;
+        }
+
+        refillQuota(t, now);
+        if (t->credit < 0) {
+            continue;
+        }
+
+        if ((best < 0) || (t->priority > _tasks[best].priority) ||
+            ((t->priority == _tasks[best].priority) && (deadline < earliest))) {
+            earliest = deadline;
+            best = i;
+        }
+    }
+
+    if (best < 0) {
+        return false;
+    }
+
+    ready = (_tasks[best].state == BMX280_TASK_IDLE) ? _tasks[best].release : _tasks[best].readyAt;
+    if ((now - ready) > _tasks[best].maxLatency) {
+        _tasks[best].maxLatency = now - ready;
+    }
+
+    if (_tasks[best].state == BMX280_TASK_IDLE) {
+        trigger(best, now);
+    } else {
+        read(best);
+    }
+
+    _busyTime += micros() - now;
+
+    return true;
+}
+
+/*!
+ * \brief Get number of missed deadlines
+ * \param task
+ *      Task index
+ * \return
+ *      Number of missed deadlines
+ */
+uint16_t ErriezBMX280Scheduler::getMisses(uint8_t task)
+{
+    if (task >= _numTasks) {
+        return 0;
+    }
+
+    return _tasks[task].misses;
+}
+
+/*!
+ * \brief Get longest time a ready transaction waited for the bus
+ * \param task
+ *      Task index
+ * \return
+ *      Latency in us
+ */
+uint32_t ErriezBMX280Scheduler::getMaxLatency(uint8_t task)
+{
+    if (task >= _numTasks) {
+        return 0;
+    }
+
+    return _tasks[task].maxLatency;
+}
+
+/*!
+ * \brief Get longest delay of a sampling instant after the start of its period
+ * \details
+ *      The sampling instant is the conversion start in forced mode and the burst read
+ *      in normal mode.
+ * \param task
+ *      Task index
+ * \return
+ *      Jitter in us
+ */
+uint32_t ErriezBMX280Scheduler::getMaxJitter(uint8_t task)
+{
+    if (task >= _numTasks) {
+        return 0;
+    }
+
+    return _tasks[task].maxJitter;
+}
+
+/*!
+ * \brief Get mean delay of the sampling instants after the start of their period
+ * \param task
+ *      Task index
+ * \return
+ *      Jitter in us
+ */
+uint32_t ErriezBMX280Scheduler::getMeanJitter(uint8_t task)
+{
+    if ((task >= _numTasks) || (_tasks[task].samples == 0)) {
+        return 0;
+    }
+
+    return _tasks[task].jitterSum / _tasks[task].samples;
+}
+
+/*!
+ * \brief Get share of time spent in bus transactions and sample callbacks
+ * \details
+ *      Calls to run() without a bus transaction are not counted, so the load shows the
+ *      CPU time left for the application when it spins on run(). Elapsed time is
+ *      accumulated by each run(), which must be called at least once per 71 minutes,
+ *      the wrap period of micros().
+ * \return
+ *      Load in 1/1000 since construction or resetStatistics()
+ */
+uint16_t ErriezBMX280Scheduler::getLoad()
+{
+    updateElapsed(micros());
+
+    if (_elapsedTime == 0) {
+        return 0;
+    }
+
+    return (uint16_t)((_busyTime * 1000) / _elapsedTime);
+}
+
+/*!
+ * \brief Clear misses, latency, jitter and load statistics of all tasks
+ */
+void ErriezBMX280Scheduler::resetStatistics()
+{
+    for (uint8_t i = 0; i < _numTasks; i++) {
+        _tasks[i].maxLatency = 0;
+        _tasks[i].maxJitter = 0;
+        _tasks[i].jitterSum = 0;
+        _tasks[i].misses = 0;
+        _tasks[i].samples = 0;
+    }
+
+    _statsTime = micros();
+    _elapsedTime = 0;
+    _busyTime = 0;
+}
+
+/*!
+ * \brief Add the time since the last update to the elapsed time of the statistics
+ * \param now
+ *      Current time in us
+ */
+void ErriezBMX280Scheduler::updateElapsed(uint32_t now)
+{
+    _elapsedTime += now - _statsTime;
+    _statsTime = now;
+}
+
+/*!
+ * \brief Start conversion of a released task
+ * \param task
+ *      Task index
+ * \param now
+ *      Current time in us
+ */
+void ErriezBMX280Scheduler::trigger(uint8_t task, uint32_t now)
+{
+    BMX280_Task_t *t = &_tasks[task];
+    uint32_t conversion = 0;
+    uint32_t start;
+
+    if (t->sensor->getMode() == BMX280_MODE_NORMAL) {
+        // Latest conversion is available in the data registers
+        recordJitter(t, now);
+        t->readyAt = now;
+        t->state = BMX280_TASK_CONVERTING;
+        read(task);
+        return;
+    }
+
+    // Skip the sample when conversion and burst read cannot complete before the deadline
+    conversion = t->sensor->getConversionTime();
+    if ((int32_t)(t->release + t->period - (now + conversion + t->busTime)) < 0) {
+        t->misses++;
+        nextPeriod(t);
+        return;
+    }
+
+    start = micros();
+    recordJitter(t, start);
+    t->sensor->startConversion();
+    t->readyAt = micros() + conversion;
+    chargeQuota(t, start);
+    t->state = BMX280_TASK_CONVERTING;
+}
+
+/*!
+ * \brief Burst read a completed conversion
+ * \param task
+ *      Task index
+ */
+void ErriezBMX280Scheduler::read(uint8_t task)
+{
+    BMX280_Task_t *t = &_tasks[task];
+    ErriezBMX280Sample sample;
+    uint32_t start;
+
+    start = micros();
+    sample = t->sensor->readAll();
+    chargeQuota(t, start);
+
+    if ((int32_t)(micros() - (t->release + t->period)) > 0) {
+        t->misses++;
+    }
+
+    nextPeriod(t);
+
+    if (_callback) {
+        _callback(task, sample);
+    }
+}
+
+/*!
+ * \brief Advance task to the next period
+ * \param t
+ *      Task
+ */
+void ErriezBMX280Scheduler::nextPeriod(BMX280_Task_t *t)
+{
+    t->release += t->period;
+    t->state = BMX280_TASK_IDLE;
+
+    // Resynchronize after an overload instead of catching up with a burst of samples
+    while ((int32_t)(micros() - (t->release + t->period)) > 0) {
+        t->release += t->period;
+        t->misses++;
+    }
+}
+
+/*!
+ * \brief Add bus time to the quota of a task, limited to the quota of one period
+ * \param t
+ *      Task
+ * \param now
+ *      Current time in us
+ */
+void ErriezBMX280Scheduler::refillQuota(BMX280_Task_t *t, uint32_t now)
+{
+    uint32_t elapsed = now - t->refill;
+    int32_t limit;
+
+    if (t->quota >= BMX280_QUOTA_UNLIMITED) {
+        t->credit = 0;
+        return;
+    }
+
+    // Refill in steps of 1ms: quota in 1/1000 equals us bus time per ms
+    elapsed /= 1000;
+    t->refill += elapsed * 1000;
+    if (elapsed > (t->period / 1000)) {
+        elapsed = t->period / 1000;
+    }
+
+    limit = (t->period / 1000) * t->quota;
+    t->credit += elapsed * t->quota;
+    if (t->credit > limit) {
+        t->credit = limit;
+    }
+}
+
+/*!
+ * \brief Charge a bus transaction to the quota of a task
+ * \param t
+ *      Task
+ * \param start
+ *      Start of the transaction in us
+ */
+void ErriezBMX280Scheduler::chargeQuota(BMX280_Task_t *t, uint32_t start)
+{
+    uint32_t duration = micros() - start;
+
+    if (duration > t->busTime) {
+        t->busTime = duration;
+    }
+    if (t->quota < BMX280_QUOTA_UNLIMITED) {
+        t->credit -= duration;
+    }
+}
+
+/*!
+ * \brief Record the delay of a sampling instant after the start of the period
+ * \param t
+ *      Task
+ * \param instant
+ *      Sampling instant in us
+ */
+void ErriezBMX280Scheduler::recordJitter(BMX280_Task_t *t, uint32_t instant)
+{
+    uint32_t jitter = instant - t->release;
+
+    if (jitter > t->maxJitter) {
+        t->maxJitter = jitter;
+    }
+
+    // Halve sum and count before overflow, the mean is kept
+    if ((t->samples == 0xFFFF) || (t->jitterSum > (0xFFFFFFFFUL - jitter))) {
+        t->jitterSum /= 2;
+        t->samples /= 2;
+    }
+    t->jitterSum += jitter;
+    t->samples++;
+}
@@ -0,0 +1,138 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Scheduler.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Non-blocking earliest-deadline-first scheduler for sensors on a shared bus
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_SCHEDULER_H_
+#define ERRIEZ_BMX280_SCHEDULER_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280.h"
+
+/*!
+ * \brief Task state
+ */
+typedef enum {
+    BMX280_TASK_IDLE = 0,                   //!< Waiting for release
+    BMX280_TASK_CONVERTING = 1              //!< Conversion started, waiting for burst read
+} BMX280_TaskState_e;
+
+/*!
+ * \brief Scheduler task, one per sensor
+ * \details
+ *      Storage is provided by the application, fields are managed by the scheduler.
+ */
+typedef struct {
+    ErriezBMX280 *sensor;       //!< Sensor
+    uint32_t period;            //!< Period in us
+    uint32_t release;           //!< Start of current period in us
+    uint32_t readyAt;           //!< Conversion complete in us
+    uint32_t maxLatency;        //!< Longest wait of a ready transaction in us
+    uint32_t maxJitter;         //!< Longest delay of a sampling instant after release in us
+    uint32_t jitterSum;         //!< Sum of sampling instant delays in us
+    int32_t credit;             //!< Remaining bus time quota in us
+    uint32_t refill;            //!< Last quota refill in us
+    uint32_t busTime;           //!< Longest bus transaction in us
+    uint16_t quota;             //!< Bus time quota in 1/1000
+    uint16_t misses;            //!< Number of missed deadlines
+    uint16_t samples;           //!< Number of sampling instants in jitterSum
+    uint8_t priority;           //!< Priority, highest first
+    uint8_t state;              //!< See BMX280_TaskState_e
+} BMX280_Task_t;
+
+/*!
+ * \brief Unlimited bus time quota
+ */
+#define BMX280_QUOTA_UNLIMITED      1000
+
+/*!
+ * \brief Sample callback
+ * \param task
+ *      Task index as returned by addSensor()
+ * \param sample
+ *      Burst sample of the task's sensor
+ */
+typedef void (*BMX280_SampleCallback)(uint8_t task, ErriezBMX280Sample &sample);
+
+/*!
+ * \brief BMX280 scheduler class
+ * \details
+ *      Each sensor is sampled once per period, the deadline is the end of the period.
+ *      Every call to run() performs at most one bus transaction: the conversion trigger
+ *      or burst read of the highest priority, earliest deadline first within a priority.
+ *      A transaction of a higher priority sensor therefore waits for at most one
+ *      transaction of a lower priority sensor. Sensors which used their bus time quota
+ *      are skipped until the quota refills. A sample that cannot complete before its
+ *      deadline is counted as miss and skipped.
+ */
+class ErriezBMX280Scheduler
+{
+public:
+    // Constructor
+    ErriezBMX280Scheduler(BMX280_Task_t *tasks, uint8_t maxTasks, BMX280_SampleCallback callback);
+
+    // Configuration
+    int8_t addSensor(ErriezBMX280 *sensor, uint16_t periodMs, uint8_t priority = 0,
+                     uint16_t quota = BMX280_QUOTA_UNLIMITED);
+    bool isFeasible();
+
+    // Call from loop()
+    bool run();
+
+    // Statistics
+    uint16_t getMisses(uint8_t task);
+    uint32_t getMaxLatency(uint8_t task);
+    uint32_t getMaxJitter(uint8_t task);
+    uint32_t getMeanJitter(uint8_t task);
+    uint16_t getLoad();
+    void resetStatistics();
+
+private:
+    BMX280_Task_t *_tasks;              //!< Task storage
+    uint8_t _maxTasks;                  //!< Size of task storage
+    uint8_t _numTasks;                  //!< Number of tasks
+    BMX280_SampleCallback _callback;    //!< Sample callback
+    uint32_t _statsTime;                //!< Time of last elapsed time update in us
+    uint64_t _elapsedTime;              //!< Time since start of statistics in us
+    uint64_t _busyTime;                 //!< Time in bus transactions and callbacks in us
+
+    void trigger(uint8_t task, uint32_t now);
+    void read(uint8_t task);
+    void nextPeriod(BMX280_Task_t *t);
+    void refillQuota(BMX280_Task_t *t, uint32_t now);
+    void chargeQuota(BMX280_Task_t *t, uint32_t start);
+    void recordJitter(BMX280_Task_t *t, uint32_t instant);
+    void updateElapsed(uint32_t now);
+};
+
+#endif // ERRIEZ_BMX280_SCHEDULER_H_
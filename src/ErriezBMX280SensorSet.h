@@ -0,0 +1,333 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280SensorSet.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Static, heap-free set of sensors for multi-sensor firmware
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_SENSOR_SET_H_
+#define ERRIEZ_BMX280_SENSOR_SET_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "ErriezBMX280.h"
+
+/*!
+ * \brief Maximum number of sensors per batched read, sets the stack use of poll()
+ */
+#define BMX280_SET_BATCH        4
+
+/*!
+ * \brief BMX280 sensor set class
+ * \details
+ *      Holds up to N sensors, their I2C multiplexer (TCA9548A) channel and last
+ *      sample in fixed size arrays, so RAM use is known at link time. Multiplexers
+ *      are switched via the bus interface of the sensor, or Wire, before each access
+ *      of a sensor by the set. poll() uses BMX280_SET_BATCH * 9 bytes of stack for
+ *      batched reads, independent of N.
+ * \tparam N
+ *      Maximum number of sensors
+ */
+template <uint8_t N>
+class ErriezBMX280SensorSet
+{
+public:
+    /*!
+     * \brief Constructor
+     */
+    ErriezBMX280SensorSet() :
+        _count(0), _muxSelectedBus(NULL), _muxSelectedAddr(0), _muxSelectedChannel(0xFF) { }
+
+    /*!
+     * \brief Add sensor, not initialized
+     * \param i2cAddr
+     *      I2C address
+     * \param bus
+     *      Bus interface, NULL = Wire
+     * \param muxAddr
+     *      I2C address of the multiplexer on the bus of the sensor, 0 = no multiplexer
+     * \param muxChannel
+     *      Multiplexer channel 0..7
+     * \return
+     *      Sensor index, -1 when the set is full
+     */
+    int8_t add(uint8_t i2cAddr, ErriezBMX280Bus *bus = NULL, uint8_t muxAddr = 0,
+               uint8_t muxChannel = 0)
+    {
+        if (_count >= N) {
+            return -1;
+        }
+
+        _sensors[_count] = ErriezBMX280(i2cAddr, bus);
+        _samples[_count] = ErriezBMX280Sample();
+        _muxAddr[_count] = muxAddr;
+        _muxChannel[_count] = muxChannel;
+
+        return _count++;
+    }
+
+    /*!
+     * \brief Initialize all sensors
+     * \return
+     *      Number of sensors detected
+     */
+    uint8_t begin()
+    {
+        uint8_t detected = 0;
+
+        for (uint8_t i = 0; i < _count; i++) {
+            select(i);
+            if (_sensors[i].begin()) {
+                detected++;
+            }
+        }
+
+        return detected;
+    }
+
+    /*!
+     * \brief Detect and initialize sensors on both I2C addresses of each multiplexer channel
+     * \param bus
+     *      Bus interface, NULL = Wire
+     * \param muxAddr
+     *      I2C address of the multiplexer, 0 = no multiplexer
+     * \param numChannels
+     *      Number of multiplexer channels to scan
+     * \return
+     *      Number of sensors added
+     */
+    uint8_t discover(ErriezBMX280Bus *bus = NULL, uint8_t muxAddr = 0, uint8_t numChannels = 1)
+    {
+        static const uint8_t addresses[2] = { BMX280_I2C_ADDR, BMX280_I2C_ADDR_ALT };
+        uint8_t added = 0;
+
+        for (uint8_t ch = 0; ch < (muxAddr ? numChannels : 1); ch++) {
+            for (uint8_t a = 0; a < sizeof(addresses); a++) {
+                int8_t i = add(addresses[a], bus, muxAddr, ch);
+
+                if (i < 0) {
+                    return added;
+                }
+                select(i);
+                if (_sensors[i].begin()) {
+                    added++;
+                } else {
+                    // Not detected: release slot
+                    _count--;
+                }
+            }
+        }
+
+        return added;
+    }
+
+    /*!
+     * \brief Burst read all sensors
+     * \details
+     *      Consecutive sensors on the same bus interface and multiplexer channel are
+     *      read with one ErriezBMX280Bus::readBatch() call per BMX280_SET_BATCH
+     *      sensors, which is counted in the bus metrics of each sensor in the batch.
+     *      Sensors on Wire are read one by one.
+     * \return
+     *      Number of valid samples
+     */
+    uint8_t poll()
+    {
+        uint8_t addrs[BMX280_SET_BATCH];
+        uint8_t data[BMX280_SET_BATCH * BME280_DATA_LEN];
+        uint8_t valid = 0;
+        uint8_t i = 0;
+
+        while (i < _count) {
+            ErriezBMX280Bus *bus = _sensors[i].getBus();
+            uint8_t len = _sensors[i].getDataLength();
+            uint8_t n = 1;
+
+            if (bus) {
+                while ((n < BMX280_SET_BATCH) && ((i + n) < _count) &&
+                       (_sensors[i + n].getBus() == bus) &&
+                       (_muxAddr[i + n] == _muxAddr[i]) &&
+                       (_muxChannel[i + n] == _muxChannel[i]) &&
+                       (_sensors[i + n].getDataLength() == len)) {
+                    n++;
+                }
+            }
+
+            select(i);
+            if (n == 1) {
+                _samples[i] = _sensors[i].readAll();
+            } else {
+                uint32_t start = micros();
+                bool success;
+
+                for (uint8_t k = 0; k < n; k++) {
+                    addrs[k] = _sensors[i + k].getAddress();
+                }
+                success = bus->readBatch(addrs, n, BMX280_REG_PRESS, data, len);
+
+                // Each sensor waited for the whole batch
+                for (uint8_t k = 0; k < n; k++) {
+                    _sensors[i + k].countTransaction(start, len, success);
+                }
+                if (success) {
+                    for (uint8_t k = 0; k < n; k++) {
+                        _samples[i + k] = _sensors[i + k].decode(&data[k * len]);
+                    }
+                } else {
+                    for (uint8_t k = 0; k < n; k++) {
+                        _sensors[i + k].flush();
+                        _samples[i + k] = ErriezBMX280Sample();
+                    }
+                }
+            }
+
+            for (uint8_t k = 0; k < n; k++) {
+                if (_samples[i + k].isValid()) {
+                    valid++;
+                }
+            }
+            i += n;
+        }
+
+        return valid;
+    }
+
+    /*!
+     * \brief Select multiplexer channel of a sensor
+     * \details
+     *      Required before accessing a sensor behind a multiplexer directly.
+     * \param index
+     *      Sensor index
+     */
+    void select(uint8_t index)
+    {
+        ErriezBMX280Bus *bus;
+        uint8_t addr;
+        uint8_t channel;
+
+        if (index >= _count) {
+            return;
+        }
+
+        // Skip the bus transactions when the channel is already selected
+        bus = _sensors[index].getBus();
+        addr = _muxAddr[index];
+        channel = _muxChannel[index];
+        if (((addr == 0) && (_muxSelectedAddr == 0)) ||
+            ((bus == _muxSelectedBus) && (addr == _muxSelectedAddr) &&
+             (channel == _muxSelectedChannel))) {
+            return;
+        }
+
+        // Disconnect the channel of another multiplexer
+        if (_muxSelectedAddr && ((_muxSelectedBus != bus) || (_muxSelectedAddr != addr))) {
+            writeMux(_muxSelectedBus, _muxSelectedAddr, 0x00);
+        }
+        if (addr) {
+            writeMux(bus, addr, 1 << channel);
+        }
+
+        _muxSelectedBus = bus;
+        _muxSelectedAddr = addr;
+        _muxSelectedChannel = channel;
+    }
+
+    /*!
+     * \brief Get number of sensors
+     * \return
+     *      Number of sensors
+     */
+    uint8_t size() const
+    {
+        return _count;
+    }
+
+    /*!
+     * \brief Get sensor
+     * \param index
+     *      Sensor index
+     * \return
+     *      Sensor
+     */
+    ErriezBMX280 &operator[](uint8_t index)
+    {
+        return _sensors[index];
+    }
+
+    /*!
+     * \brief Get last sample read by poll()
+     * \param index
+     *      Sensor index
+     * \return
+     *      Sample
+     */
+    ErriezBMX280Sample &getSample(uint8_t index)
+    {
+        return _samples[index];
+    }
+
+private:
+    ErriezBMX280 _sensors[N];           //!< Sensors
+    ErriezBMX280Sample _samples[N];     //!< Last samples
+    uint8_t _muxAddr[N];                //!< Multiplexer I2C address, 0 = none
+    uint8_t _muxChannel[N];             //!< Multiplexer channel
+    uint8_t _count;                     //!< Number of sensors
+    ErriezBMX280Bus *_muxSelectedBus;   //!< Bus of the selected multiplexer, NULL = Wire
+    uint8_t _muxSelectedAddr;           //!< Multiplexer with selected channel, 0 = none
+    uint8_t _muxSelectedChannel;        //!< Selected multiplexer channel
+
+    /*!
+     * \brief Write multiplexer control register
+     * \details
+     *      The TCA9548A has no register address and keeps the last byte of a write,
+     *      so a register write of the mask to the mask selects the channels via a
+     *      bus interface.
+     * \param bus
+     *      Bus interface, NULL = Wire
+     * \param muxAddr
+     *      I2C address of the multiplexer
+     * \param channels
+     *      Bit mask of enabled channels
+     */
+    void writeMux(ErriezBMX280Bus *bus, uint8_t muxAddr, uint8_t channels)
+    {
+        if (bus) {
+            bus->write(muxAddr, channels, channels);
+            return;
+        }
+
+        Wire.beginTransmission(muxAddr);
+        Wire.write(channels);
+        Wire.endTransmission();
+    }
+};
+
+#endif // ERRIEZ_BMX280_SENSOR_SET_H_
@@ -0,0 +1,124 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/*!
+ * \file ErriezBMX280Storage.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Storage interface for sample logs
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_STORAGE_H_
+#define ERRIEZ_BMX280_STORAGE_H_
+
+#include <Arduino.h>
+
+/*!
+ * \brief BMX280 storage interface class
+ * \details
+ *      Byte addressable non-volatile memory, for example FRAM, battery backed RAM,
+ *      EEPROM or flash. Implement this interface for the memory used by a sample log.
+ */
+class ErriezBMX280Storage
+{
+public:
+    /*!
+     * \brief Read bytes
+     * \param addr
+     *      Start address
+     * \param buffer
+     *      Buffer to store bytes
+     * \param len
+     *      Number of bytes
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Read failed
+     */
+    virtual bool read(uint32_t addr, uint8_t *buffer, uint16_t len) = 0;
+
+    /*!
+     * \brief Write bytes
+     * \param addr
+     *      Start address
+     * \param buffer
+     *      Bytes to write
+     * \param len
+     *      Number of bytes
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Write failed
+     */
+    virtual bool write(uint32_t addr, const uint8_t *buffer, uint16_t len) = 0;
+
+    /*!
+     * \brief Get storage size
+     * \return
+     *      Size in bytes
+     */
+    virtual uint32_t size() = 0;
+
+    /*!
+     * \brief Erase bytes before writing
+     * \details
+     *      Default: not required for byte writable memories. Override for flash, the
+     *      range is always a complete log page.
+     * \param addr
+     *      Start address
+     * \param len
+     *      Number of bytes
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Erase failed
+     */
+    virtual bool erase(uint32_t addr, uint32_t len)
+    {
+        (void)addr;
+        (void)len;
+
+        return true;
+    }
+
+    /*!
+     * \brief Make written bytes persistent
+     * \details
+     *      Default: writes are persistent immediately. Override for write caches.
+     * \retval true
+     *      Success
+     * \retval false
+     *      Error: Write failed
+     */
+    virtual bool sync()
+    {
+        return true;
+    }
+};
+
+#endif // ERRIEZ_BMX280_STORAGE_H_
@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Stream.cpp
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Continuous sample stream as input range
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#include "ErriezBMX280.h"
+
+/*!
+ * \brief Constructor
+ * \param sensor
+ *      Initialized sensor
+ * \param intervalMs
+ *      Time between samples in ms, 0 = sample period of the sensor configuration
+ * \param count
+ *      Number of samples, 0 = endless
+ */
+ErriezBMX280Stream::ErriezBMX280Stream(ErriezBMX280 *sensor, uint16_t intervalMs, uint32_t count) :
+    _sensor(sensor), _deadline(0), _remaining(count), _endless(count == 0),
+    _started(false), _done(false)
+{
+    _interval = intervalMs ? (intervalMs * 1000UL) : sensor->getSamplePeriod();
+}
+
+/*!
+ * \brief Read first sample
+ * \return
+ *      Iterator to the first sample
+ */
+ErriezBMX280Stream::Iterator ErriezBMX280Stream::begin()
+{
+    if (!_started) {
+        next();
+    }
+
+    return Iterator(this);
+}
+
+/*!
+ * \brief End of stream
+ * \return
+ *      End iterator
+ */
+ErriezBMX280Stream::Iterator ErriezBMX280Stream::end()
+{
+    return Iterator(NULL);
+}
+
+/*!
+ * \brief Wait for next deadline and read sample
+ */
+void ErriezBMX280Stream::next()
+{
+    if (!_endless) {
+        if (_remaining == 0) {
+            _done = true;
+            return;
+        }
+        _remaining--;
+    }
+
+    if (_started) {
+        while ((int32_t)(micros() - _deadline) < 0) {
+            yield();
+        }
+        // Skip missed deadlines instead of reading a burst of late samples
+        if ((micros() - _deadline) >= _interval) {
+            _deadline = micros();
+        }
+        _deadline += _interval;
+    } else {
+        _deadline = micros() + _interval;
+        _started = true;
+    }
+
+    if (_sensor->getMode() != BMX280_MODE_NORMAL) {
+        _sensor->startConversion();
+        _sensor->waitConversion();
+    }
+
+    _sample = _sensor->readAll();
+}
@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezBMX280Stream.h
+ * \brief BMP280/BME280 sensor library for Arduino.
+ * \details
+ *      Continuous sample stream as input range
+ * \details
+ *     Source:          https://github.com/Erriez/ErriezBMX280
+ *     Documentation:   https://erriez.github.io/ErriezBMX280
+ */
+
+#ifndef ERRIEZ_BMX280_STREAM_H_
+#define ERRIEZ_BMX280_STREAM_H_
+
+#include <Arduino.h>
+
+#include "ErriezBMX280Sample.h"
+
+class ErriezBMX280;
+
+/*!
+ * \brief BMX280 sample stream class
+ * \details
+ *      Input range yielding one burst sample per interval. Forced mode triggers
+ *      a conversion per sample and waits for completion. Normal mode reads the
+ *      latest conversion. Pacing is drift free: deadlines advance by the
+ *      interval, not by the time spent in the loop body.
+ */
+class ErriezBMX280Stream
+{
+public:
+    /*!
+     * \brief Single pass iterator
+     */
+    class Iterator
+    {
+    public:
+        /*!
+         * \brief Constructor
+         * \param stream
+         *      Stream or NULL for end iterator
+         */
+        Iterator(ErriezBMX280Stream *stream) : _stream(stream) { }
+
+        /*!
+         * \brief Get current sample
+         * \return
+         *      Sample
+         */
+        ErriezBMX280Sample &operator*() { return _stream->_sample; }
+
+        /*!
+         * \brief Wait for and read next sample
+         * \return
+         *      Iterator
+         */
+        Iterator &operator++() { _stream->next(); return *this; }
+
+        /*!
+         * \brief Compare with end iterator
+         * \return
+         *      true when samples remaining
+         */
+        bool operator!=(const Iterator &) const { return (_stream != NULL) && !_stream->_done; }
+
+    private:
+        ErriezBMX280Stream *_stream;    //!< Stream
+    };
+
+    // Constructor
+    ErriezBMX280Stream(ErriezBMX280 *sensor, uint16_t intervalMs, uint32_t count);
+
+    // Range
+    Iterator begin();
+    Iterator end();
+
+private:
+    ErriezBMX280 *_sensor;          //!< Sensor
+    ErriezBMX280Sample _sample;     //!< Current sample
+    uint32_t _interval;             //!< Interval in us
+    uint32_t _deadline;             //!< Time of next sample in us
+    uint32_t _remaining;            //!< Number of remaining samples
+    bool _endless;                  //!< No sample limit
+    bool _started;                  //!< First sample read
+    bool _done;                     //!< All samples read
+
+    void next();
+};
+
+#endif // ERRIEZ_BMX280_STREAM_H_